@@ -0,0 +1,231 @@
+#include "entityWorld.h"
+#include <cmath>
+
+/**
+ * Clips of the map entities, looked up by name once
+ */
+struct EntityClips {
+    ClipId tutorialArrow, sacredFruit;
+};
+
+const EntityClips& getEntityClips() {
+    static const EntityClips clips = {getAnimations().find("tutorial_arrow"), getAnimations().find("sacred_fruit")};
+    return clips;
+}
+
+/**
+ * Add an entity with default values for the given components, returns its index
+ */
+Entity EntityWorld::create(uint8_t components, Vector2f position) {
+    Entity entity = this->components.size();
+    this->components.push_back(components | COMPONENT_TRANSFORM);
+    transforms.position.push_back(position);
+    boxes.offset.push_back({0, 0});
+    boxes.size.push_back({0, 0});
+    animations.add(0);
+    animations.finished.back() = !(components & COMPONENT_ANIMATION);
+    triggers.activated.push_back(false);
+    triggers.text.push_back(NO_TEXT);
+    collectibles.collected.push_back(false);
+    collectibles.finishesLevel.push_back(false);
+    return entity;
+}
+
+/**
+ * Create a map entity of a level from its type
+ * Tutorial arrows are triggers showing their text, the sacred fruit is collected to finish the level
+ */
+Entity EntityWorld::spawn(const EntitySpawn& spawn) {
+    if (spawn.type == MapEntityType::TUTORIAL_ARROW) {
+        Entity entity = create(COMPONENT_AABB | COMPONENT_ANIMATION | COMPONENT_TRIGGER | COMPONENT_SPRITE, spawn.position);
+        boxes.size[entity] = {16, 48};
+        animations.clip[entity] = getEntityClips().tutorialArrow;
+        if (!spawn.tutorialText.empty()) {
+            triggers.text[entity] = texts.size();
+            texts.push_back(string(spawn.tutorialText));
+            if (atlas != nullptr) {
+                addTextDrawable(entity);
+            }
+        }
+        return entity;
+    }
+    if (spawn.type == MapEntityType::SACRED_FRUIT) {
+        Entity entity = create(COMPONENT_AABB | COMPONENT_ANIMATION | COMPONENT_COLLECTIBLE | COMPONENT_SPRITE, spawn.position);
+        boxes.size[entity] = Vector2f(TILE_SIZE);
+        animations.clip[entity] = getEntityClips().sacredFruit;
+        collectibles.finishesLevel[entity] = true;
+        return entity;
+    }
+    // Unknown tags keep a box so they still take part in overlap queries, they do nothing
+    Entity entity = create(COMPONENT_AABB, spawn.position);
+    boxes.size[entity] = Vector2f(TILE_SIZE);
+    return entity;
+}
+
+void EntityWorld::clear() {
+    *this = EntityWorld();
+}
+
+/**
+ * Draw the entities from the atlas, only needed to draw them
+ */
+void EntityWorld::loadGraphics(const TextureAtlas& atlas) {
+    this->atlas = &atlas;
+    textDrawables.clear();
+    for (Entity entity = 0; entity < components.size(); entity++) {
+        if (triggers.text[entity] != NO_TEXT) {
+            addTextDrawable(entity);
+        }
+    }
+}
+
+/**
+ * Lay out the tutorial text of a trigger above it, texts are added in the order of their index
+ */
+void EntityWorld::addTextDrawable(Entity entity) {
+    Text text(getGameFont(), texts[triggers.text[entity]], 20);
+    text.setOutlineThickness(1);
+    text.setOutlineColor(Color::Black);
+    text.setOrigin(text.getGlobalBounds().getCenter());
+    text.setPosition(transforms.position[entity] - Vector2f(0, TUTORIAL_TEXT_HEIGHT));
+    textDrawables.push_back(text);
+}
+
+size_t EntityWorld::size() const {
+    return components.size();
+}
+
+/**
+ * Memory taken by one entity in the component arrays, tutorial texts aside
+ */
+size_t EntityWorld::getBytesPerEntity() const {
+    return sizeof(uint8_t) * 4 + sizeof(Vector2f) * 3 + sizeof(ClipId) + sizeof(int32_t) + sizeof(float) * 2 + sizeof(uint32_t);
+}
+
+bool EntityWorld::has(Entity entity, uint8_t component) const {
+    return (components[entity] & component) == component;
+}
+
+Vector2f EntityWorld::getPosition(Entity entity) const {
+    return transforms.position[entity];
+}
+
+void EntityWorld::setPosition(Entity entity, Vector2f position) {
+    transforms.position[entity] = position;
+    if (triggers.text[entity] < textDrawables.size()) {
+        textDrawables[triggers.text[entity]].setPosition(position - Vector2f(0, TUTORIAL_TEXT_HEIGHT));
+    }
+}
+
+void EntityWorld::setBox(Entity entity, Vector2f offset, Vector2f size) {
+    components[entity] |= COMPONENT_AABB;
+    boxes.offset[entity] = offset;
+    boxes.size[entity] = size;
+}
+
+FloatRect EntityWorld::getBounds(Entity entity) const {
+    return FloatRect(transforms.position[entity] + boxes.offset[entity], boxes.size[entity]);
+}
+
+bool EntityWorld::isActivated(Entity entity) const {
+    return triggers.activated[entity];
+}
+
+bool EntityWorld::isCollected(Entity entity) const {
+    return collectibles.collected[entity];
+}
+
+bool EntityWorld::finishesLevel(Entity entity) const {
+    return collectibles.finishesLevel[entity];
+}
+
+/**
+ * Animation system, every animated entity of the world in order
+ */
+void EntityWorld::animate(float deltaTime) {
+    getAnimations().update(animations, deltaTime);
+}
+
+/**
+ * Animation system, only the given entities (the ones awake)
+ */
+void EntityWorld::animate(const vector<Entity>& entities, float deltaTime) {
+    const AnimationLibrary& library = getAnimations();
+    for (Entity entity : entities) {
+        if (animations.finished[entity]) {
+            continue;
+        }
+        if (library.advance(animations.clip[entity], animations.frame[entity], animations.frameTimer[entity], animations.clipTimer[entity], deltaTime) 
+            == AnimationStep::OVER) {
+            animations.finished[entity] = true;
+        }
+    }
+}
+
+/**
+ * Catch up with the time an entity was not updated, only the looping clips of the entities have to look right
+ */
+void EntityWorld::wake(Entity entity, float sleptTime) {
+    if (animations.finished[entity]) {
+        return;
+    }
+    getAnimations().catchUp(animations.clip[entity], animations.frame[entity], animations.frameTimer[entity], sleptTime);
+}
+
+/**
+ * Trigger and collectible system, fed with the entities the player overlapped last tick and the ones it overlaps now
+ * Collecting an entity that finishes the level finishes it
+ */
+void EntityWorld::updateTriggers(const vector<Entity>& previous, const vector<Entity>& current, bool& gameFinished) {
+    for (Entity entity : previous) {
+        triggers.activated[entity] = false;
+    }
+    for (Entity entity : current) {
+        if (components[entity] & COMPONENT_TRIGGER) {
+            triggers.activated[entity] = true;
+        }
+        if (components[entity] & COMPONENT_COLLECTIBLE) {
+            collectibles.collected[entity] = true;
+            if (collectibles.finishesLevel[entity]) {
+                gameFinished = true;
+            }
+        }
+    }
+}
+
+/**
+ * Put every collectible back, snapshots do not keep which ones were collected
+ */
+void EntityWorld::resetCollectibles() {
+    fill(collectibles.collected.begin(), collectibles.collected.end(), false);
+}
+
+/**
+ * Add the current frame of the given entities to the batch
+ */
+void EntityWorld::draw(SpriteBatch& batch, const vector<Entity>& entities) const {
+    if (atlas == nullptr) {
+        return;
+    }
+    const AnimationLibrary& library = getAnimations();
+    for (Entity entity : entities) {
+        if (!(components[entity] & COMPONENT_SPRITE) || collectibles.collected[entity]) {
+            continue;
+        }
+        ClipId clip = animations.clip[entity];
+        Vector2f position = transforms.position[entity] + library.getFrameOffset(clip, animations.frame[entity]);
+        batch.add(atlas->getTexture(), atlas->map(library.getClip(clip).region, library.getFrameRect(clip, animations.frame[entity])), position, LAYER_ENTITIES);
+    }
+}
+
+/**
+ * Draw the text of the activated tutorial arrows above them, after the sprites
+ */
+void EntityWorld::drawTexts(RenderTarget& target, const vector<Entity>& entities) const {
+    for (Entity entity : entities) {
+        if (!(components[entity] & COMPONENT_TRIGGER) || !triggers.activated[entity] || triggers.text[entity] >= textDrawables.size()) {
+            continue;
+        }
+        target.draw(textDrawables[triggers.text[entity]]);
+    }
+}
\ No newline at end of file
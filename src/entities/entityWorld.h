@@ -0,0 +1,113 @@
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../util/globalConstants.h"
+#include "../sys/animation.h"
+#include "../sys/spriteBatch.h"
+
+using namespace std;
+using namespace sf;
+
+#define TUTORIAL_ARROW_FILENAME "assets/entities/tutorial arrow.png"
+#define SACRED_FRUIT_FILENAME "assets/entities/sacred fruit.png"
+#define TUTORIAL_TEXT_HEIGHT 32.0f // Tutorial texts are centered this far above their arrow
+
+enum class MapEntityType { _NULL, TUTORIAL_ARROW, SACRED_FRUIT };
+
+typedef uint32_t Entity; // Index of the entity in every component array
+
+/**
+ * Components an entity has, one bit each
+ */
+enum Component : uint8_t {
+    COMPONENT_TRANSFORM = 1 << 0,
+    COMPONENT_AABB = 1 << 1,
+    COMPONENT_ANIMATION = 1 << 2,
+    COMPONENT_TRIGGER = 1 << 3,
+    COMPONENT_COLLECTIBLE = 1 << 4,
+    COMPONENT_SPRITE = 1 << 5
+};
+
+/**
+ * Entity of a level as read from the level file, spawned into the world of every game playing the level
+ */
+struct EntitySpawn {
+    MapEntityType type;
+    Vector2f position;
+    string_view tutorialText; // Owned by the level
+};
+
+/**
+ * Every component is a set of arrays indexed by entity, entities without the component keep default values
+ * Systems go through the arrays in order instead of calling a method on each entity
+ */
+struct TransformComponents {
+    vector<Vector2f> position;
+};
+
+struct AABBComponents {
+    vector<Vector2f> offset; // From the transform
+    vector<Vector2f> size;
+};
+
+struct TriggerComponents {
+    vector<uint8_t> activated; // The player overlaps the trigger
+    vector<uint32_t> text; // Index in the tutorial texts, NO_TEXT for triggers without one
+};
+
+struct CollectibleComponents {
+    vector<uint8_t> collected;
+    vector<uint8_t> finishesLevel;
+};
+
+#define NO_TEXT UINT32_MAX
+
+/**
+ * Map entities and the player as plain arrays of components
+ */
+class EntityWorld {
+    private:
+        vector<uint8_t> components;
+        TransformComponents transforms;
+        AABBComponents boxes;
+        Animators animations; // Entities without the animation component are created finished so the animation system skips them
+        TriggerComponents triggers;
+        CollectibleComponents collectibles;
+        vector<string> texts;
+        vector<Text> textDrawables; // One per tutorial text once graphics are loaded, laid out once instead of every frame
+
+        const TextureAtlas* atlas = nullptr;
+
+        void addTextDrawable(Entity entity);
+
+    public:
+        Entity create(uint8_t components, Vector2f position);
+        Entity spawn(const EntitySpawn& spawn);
+        void clear();
+        void loadGraphics(const TextureAtlas& atlas);
+        size_t size() const;
+        size_t getBytesPerEntity() const;
+        bool has(Entity entity, uint8_t component) const;
+        Vector2f getPosition(Entity entity) const;
+        void setPosition(Entity entity, Vector2f position);
+        void setBox(Entity entity, Vector2f offset, Vector2f size);
+        FloatRect getBounds(Entity entity) const;
+        bool isActivated(Entity entity) const;
+        bool isCollected(Entity entity) const;
+        bool finishesLevel(Entity entity) const;
+
+        void animate(float deltaTime);
+        void animate(const vector<Entity>& entities, float deltaTime);
+        void wake(Entity entity, float sleptTime);
+        void updateTriggers(const vector<Entity>& previous, const vector<Entity>& current, bool& gameFinished);
+        void resetCollectibles();
+        void draw(SpriteBatch& batch, const vector<Entity>& entities) const;
+        void drawTexts(RenderTarget& target, const vector<Entity>& entities) const;
+};
+
+#endif
\ No newline at end of file
@@ -1,10 +1,24 @@
 #include "player.h"
 
-Player::Player(Vector2f spawnPosition) : sprite(texture) {
-    texture = Texture(PLAYER_SPRITE_FILENAME, false, IntRect({0, 0}, PLAYER_SPRITE_SIZE));
-    sprite = Sprite(texture);
+/**
+ * Clips of the player sheet, looked up by name once
+ */
+struct PlayerClips {
+    ClipId idle, walk, run, jump, land, dash, die;
+};
+
+const PlayerClips& getPlayerClips() {
+    static const PlayerClips clips = [] {
+        const AnimationLibrary& animations = getAnimations();
+        return PlayerClips{animations.find("player_idle"), animations.find("player_walk"), animations.find("player_run"), 
+            animations.find("player_jump"), animations.find("player_land"), animations.find("player_dash"), animations.find("player_die")};
+    }();
+    return clips;
+}
+
+Player::Player(Vector2f spawnPosition) : sprite(getPlaceholderTexture()) {
     sprite.setPosition(spawnPosition); 
-    sprite.setTextureRect(IntRect({0, 0}, {frameWidth, frameHeight}));
+    setFrame(getAnimations().getFrameRect(getPlayerClips().idle, 0));
     
     health = 100;
     hitbox = RectangleShape(HITBOX_SIZE);
@@ -29,6 +43,88 @@ Player::Player(Vector2f spawnPosition) : sprite(texture) {
     colliding = true;
 }
 
+/**
+ * Draw the player from the atlas holding its sprite sheet, only needed to draw the player
+ */
+void Player::loadGraphics(const TextureAtlas& atlas) {
+    this->atlas = &atlas;
+    sprite.setTexture(atlas.getTexture());
+    setFrame(frameRect);
+}
+
+/**
+ * Show a frame of the sprite sheet, rect is in sheet coordinates
+ */
+void Player::setFrame(IntRect rect) {
+    frameRect = rect;
+    sprite.setTextureRect(atlas != nullptr ? atlas->map(AtlasRegion::PLAYER, rect) : rect);
+}
+
+/**
+ * Copy the state of the player, the snapshot must be zeroed first so its padding compares equal
+ */
+void Player::saveState(PlayerSnapshot& snapshot) const {
+    snapshot.spritePosition = sprite.getPosition();
+    snapshot.hitboxPosition = hitbox.getPosition();
+    snapshot.textureRect = frameRect;
+    snapshot.speed = speed;
+    snapshot.maxSpeed = maxSpeed;
+    snapshot.airboneXSpeedSnapshot = airboneXSpeedSnapshot;
+    snapshot.animationTimer = animationTimer;
+    snapshot.totalAnimationTimer = totalAnimationTimer;
+    snapshot.collisionTimer = collisionTimer;
+    snapshot.health = health;
+    snapshot.direction = direction;
+    snapshot.currentFrame = currentFrame;
+    snapshot.groundedState = groundedState;
+    snapshot.dyingState = dyingState;
+    snapshot.landingState = landingState;
+    snapshot.dashingState = dashingState;
+    snapshot.jumpingState = jumpingState;
+    snapshot.canDash = canDash;
+    snapshot.colliding = colliding;
+
+    // Only jumps are buffered, one at a time, so the queue never gets close to the limit
+    queue<Action> actions = actionQueue;
+    snapshot.queuedActionCount = 0;
+    while (!actions.empty() && snapshot.queuedActionCount < MAX_QUEUED_ACTIONS) {
+        snapshot.queuedActions[snapshot.queuedActionCount++] = actions.front();
+        actions.pop();
+    }
+}
+
+void Player::loadState(const PlayerSnapshot& snapshot) {
+    sprite.setPosition(snapshot.spritePosition);
+    hitbox.setPosition(snapshot.hitboxPosition);
+    setFrame(snapshot.textureRect);
+    speed = snapshot.speed;
+    maxSpeed = snapshot.maxSpeed;
+    airboneXSpeedSnapshot = snapshot.airboneXSpeedSnapshot;
+    animationTimer = snapshot.animationTimer;
+    totalAnimationTimer = snapshot.totalAnimationTimer;
+    collisionTimer = snapshot.collisionTimer;
+    health = snapshot.health;
+    currentFrame = snapshot.currentFrame;
+    groundedState = snapshot.groundedState;
+    dyingState = snapshot.dyingState;
+    landingState = snapshot.landingState;
+    dashingState = snapshot.dashingState;
+    jumpingState = snapshot.jumpingState;
+    canDash = snapshot.canDash;
+    colliding = snapshot.colliding;
+
+    actionQueue = queue<Action>();
+    for (int i = 0; i < snapshot.queuedActionCount; i++) {
+        actionQueue.push(snapshot.queuedActions[i]);
+    }
+
+    if (snapshot.direction < 0) {
+        faceLeft();
+    } else {
+        faceRight();
+    }
+}
+
 RectangleShape& Player::getHitbox() {
     return hitbox;
 }
@@ -40,17 +136,17 @@ Sprite& Player::getSprite() {
 /**
  * Handle player actions, animation states
  */
-void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& input) {
+void Player::update(float deltaTime, GameClock& globalClock, const Level& level, const Input& input) {
     // cout << sprite.getPosition().x << "," << sprite.getPosition().y << endl;
 
     // Player is dying
     if (dyingState) {
-        if (animate(deltaTime, 0.2f, 0, SPRITE_OFFSET_DYING, 3, false)) {
+        if (animate(deltaTime, getPlayerClips().die)) {
             dyingState = false;
             faceRight();
             globalClock.restart();
             sprite.setPosition(Vector2f(level.getSpawnPosition()));
-            sprite.setTextureRect(IntRect({0, 0}, {frameWidth, frameHeight}));
+            setFrame(getAnimations().getFrameRect(getPlayerClips().idle, 0));
             // actionQueue = queue<Action>();
             resetSpeed();
             resetAnimation();
@@ -61,7 +157,7 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
 
     // Player is landing from a fall
     if (landingState && !jumpingState) {
-        if (animate(deltaTime, 0.04f, 4 * 32, SPRITE_OFFSET_JUMPING, 4, false)) {
+        if (animate(deltaTime, getPlayerClips().land)) {
             resetAnimation();
             landingState = false;
         }
@@ -70,7 +166,7 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
     // Player is dashing
     if (dashingState) {
         speed.y = 0;
-        animate(deltaTime, 0.01f, 0, 9 * 32, 8, true);
+        animate(deltaTime, getPlayerClips().dash);
         applyFriction(deltaTime, 4.0f);
         if (abs(speed.x) <= MAX_SPEED_RUNNING) {
             dashingState = false;
@@ -79,21 +175,21 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
 
     if (groundedState && !landingState && !dashingState) {
         if (abs(speed.x) > 0 && abs(speed.x) <= MAX_SPEED_WALKING + 25.0f) {
-            animate(deltaTime, 0.1f, 0, SPRITE_OFFSET_WALKING, WALKING_FRAMES, true);
+            animate(deltaTime, getPlayerClips().walk);
         } else if (abs(speed.x) > MAX_SPEED_WALKING + 25.0f) {
-            animate(deltaTime, 0.1f, 0, SPRITE_OFFSET_RUNNING, RUNNING_FRAMES, true);
+            animate(deltaTime, getPlayerClips().run);
         } else if (abs(speed.x) == 0) {
             resetAnimation();
-            sprite.setTextureRect(IntRect({0, 0}, {frameWidth, frameHeight}));
+            setFrame(getAnimations().getFrameRect(getPlayerClips().idle, 0));
         }
     }
     
     if (!dashingState || speed.y < 0) {
-        if (Keyboard::isKeyPressed(Keyboard::Key::Right)) {
+        if (input.isKeyHeld(Keyboard::Scancode::Right)) {
             faceRight();
     
             // Accelerate right
-            if (!(Keyboard::isKeyPressed(Keyboard::Key::Left))) {
+            if (!(input.isKeyHeld(Keyboard::Scancode::Left))) {
                 speed.x += acceleration.x * deltaTime;
             } 
             
@@ -101,11 +197,11 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
             if (speed.x < 0) {
                 applyFriction(deltaTime, abs(speed.x) / 40);
             }
-        } else if (Keyboard::isKeyPressed(Keyboard::Key::Left)) {
+        } else if (input.isKeyHeld(Keyboard::Scancode::Left)) {
             faceLeft();
     
             // Accelerate left 
-            if (!(Keyboard::isKeyPressed(Keyboard::Key::Right))) {
+            if (!(input.isKeyHeld(Keyboard::Scancode::Right))) {
                 speed.x -= acceleration.x * deltaTime;
             } 
     
@@ -119,7 +215,7 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
 
         // Finish the jumping animation if the player started jumping
         if (jumpingState) {
-            jumpingState = !animate(deltaTime, 0.04f, 0, SPRITE_OFFSET_JUMPING, 6, false);
+            jumpingState = !animate(deltaTime, getPlayerClips().jump);
         }
 
         // Falling
@@ -166,7 +262,7 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
     }
 
     // Running and walking
-    if (Keyboard::isKeyPressed(Keyboard::Key::LShift) && groundedState) {
+    if (input.isKeyHeld(Keyboard::Scancode::LShift) && groundedState) {
         maxSpeed = MAX_SPEED_RUNNING;
     } else {
         if (!groundedState) {
@@ -179,11 +275,11 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
 
     // cout << speed.x * deltaTime << endl;
 
-    // updatePosition(deltaTime, speed.x * deltaTime, speed.y * deltaTime, level);
+    // updatePosition(speed.x * deltaTime, speed.y * deltaTime, level);
     // Vector2f remainder = {abs(speed.x) * deltaTime, abs(speed.y) * deltaTime};
     // Vector2i sign = {speed.x > 0 ? 1 : -1, speed.y > 0 ? 1 : -1};
 
-    updatePosition2({speed.x * deltaTime, speed.y * deltaTime}, deltaTime, level);
+    updatePosition2({speed.x * deltaTime, speed.y * deltaTime}, level);
 }
 
 /**
@@ -192,12 +288,12 @@ void Player::update(float deltaTime, Clock& globalClock, Level& level, Input& in
  * 
  * More robust than v1
  */
-void Player::updatePosition(float deltaTime, float dx, float dy, Level& level) {
+void Player::updatePosition(float dx, float dy, const Level& level) {
 
     Vector2f remainder = {};
 
-    std::vector<std::vector<Tile>> tiles = level.getTiles();
-    Vector2u levelSize = level.getSize();
+    const TileMap& tiles = level.getTiles();
+    Vector2u levelSize = tiles.getSize();
 
     // Move the player in axis X (0) or Y (1) and handle collisions if necessary
     auto movePlayer = [&](int& move, int axis) {
@@ -233,14 +329,14 @@ void Player::updatePosition(float deltaTime, float dx, float dy, Level& level) {
                         if (x < 0 || y < 0 || x >= levelSize.x || y >= levelSize.y) {
                             continue;
                         }
-                        if (checkCollision(hitbox, tiles[x][y].getHitbox())) {
-                            if (tiles[x][y].isSolid()) {
+                        if (checkCollision(hitbox, tiles.getHitbox(x, y))) {
+                            if (tiles.isSolid(x, y)) {
                                 cout << "collision" << endl;
                                 if (axis == 0) speed.x = 0;
                                 if (axis == 1) speed.y = 0;
                                 return;
                             }
-                            if (tiles[x][y].isDangerous()) {
+                            if (tiles.isDangerous(x, y)) {
                                 kill();
                                 return;
                             }
@@ -270,14 +366,11 @@ void Player::updatePosition(float deltaTime, float dx, float dy, Level& level) {
     movePlayer(moveX, 0);
     updateHitbox();
 
-    updateGroundedState(deltaTime, tiles, levelSize);
+    updateGroundedState(level);
 }
 
-void Player::updatePosition2(Vector2f deltaPosition, float deltaTime, Level& level) {
+void Player::updatePosition2(Vector2f deltaPosition, const Level& level) {
 
-    std::vector<std::vector<Tile>> tiles = level.getTiles();
-    Vector2u levelSize = level.getSize();
-    
     // if (sign.y == 1 && remainder.y > 0 || sign.y == -1 && remainder.y < 0) {
     //     float distanceY = sign.y;
     //     if (movePlayer(distanceY, 'y', tiles, levelSize)) {
@@ -292,106 +385,136 @@ void Player::updatePosition2(Vector2f deltaPosition, float deltaTime, Level& lev
     //     }
     // }
 
-    movePlayer(deltaPosition.y, deltaTime, 'y', tiles, levelSize);
+    movePlayer(deltaPosition.y, 'y', level);
     updateHitbox();
 
-    movePlayer(deltaPosition.x, deltaTime, 'x', tiles, levelSize);
+    movePlayer(deltaPosition.x, 'x', level);
     updateHitbox();
 
-    updateGroundedState(deltaTime, tiles, levelSize);
+    updateGroundedState(level);
 }
 
-void Player::movePlayer(float distance, float deltaTime, char axis, vector<vector<Tile>>& tiles, Vector2u levelSize) {
-    
-    bool colliding = false;
-    float moved = abs(distance);
-    int moveSign = copysign(1.0, distance);
+/**
+ * Move the player along one axis with a swept AABB test against the tile grid
+ * The hitbox is moved straight to the first solid tile or level edge in its way, only the tiles 
+ * covered by the swept hitbox are visited so the result does not depend on the frame rate
+ */
+void Player::movePlayer(float distance, char axis, const Level& level) {
+    if (distance == 0) {
+        return;
+    }
+
+    const TileMap& tiles = level.getTiles();
+    Vector2u levelSize = tiles.getSize();
+    FloatRect box = hitbox.getGlobalBounds();
+    int sign = distance > 0 ? 1 : -1;
+    float allowed = abs(distance);
+
+    // Position of the hitbox sides along the axis of movement
+    float boxStart = axis == 'x' ? box.position.x : box.position.y;
+    float boxSize = axis == 'x' ? box.size.x : box.size.y;
+    float boxFront = sign > 0 ? boxStart + boxSize : boxStart;
+
+    // Level edges
+    float levelEnd = axis == 'x' ? levelSize.x * TILE_SIZE.x : levelSize.y * TILE_SIZE.y;
+    float edgeDistance = sign > 0 ? levelEnd - boxFront : boxFront;
+    bool reachesEdge = edgeDistance < allowed;
+    allowed = max(0.0f, min(allowed, edgeDistance));
+
+    // Tiles covered by the hitbox swept over the whole distance
+    FloatRect swept = box;
+    if (axis == 'x') {
+        swept.size.x += allowed;
+        if (sign < 0) swept.position.x -= allowed;
+    } else {
+        swept.size.y += allowed;
+        if (sign < 0) swept.position.y -= allowed;
+    }
+    IntRect range({(int) floor(swept.position.x / TILE_SIZE.x), (int) floor(swept.position.y / TILE_SIZE.y)}, {0, 0});
+    range.size = {(int) floor((swept.position.x + swept.size.x) / TILE_SIZE.x) - range.position.x + 1, 
+        (int) floor((swept.position.y + swept.size.y) / TILE_SIZE.y) - range.position.y + 1};
+
+    // Time of impact against every solid tile in the way
+    bool blocked = false;
+    tiles.findTiles(range, TILE_SOLID, [&](int x, int y) {
+        // Solid pixels of the tile in the rows (or columns) the hitbox covers, touching sides do not collide
+        float tileStart, tileEnd;
+        if (!level.getTileMask(x, y).getExtent(getTileOrigin(x, y), box, axis, tileStart, tileEnd)) {
+            return false;
+        }
+        // Tile behind the hitbox
+        if ((sign > 0 && tileEnd <= boxStart) || (sign < 0 && tileStart >= boxStart + boxSize)) {
+            return false;
+        }
+        // One way tiles only stop the player falling on them from above
+        if ((tiles.getFlags(x, y) & TILE_ONE_WAY) && (axis != 'y' || sign < 0 || boxFront > tileStart)) {
+            return false;
+        }
 
-    while (moved > 0) {
-        int playerGridPositonX = hitbox.getPosition().x / TILE_SIZE.x;
-        int playerGridPositonY = hitbox.getPosition().y / TILE_SIZE.y;
+        float impact = max(0.0f, sign > 0 ? tileStart - boxFront : boxFront - tileEnd);
+        if (impact <= allowed) {
+            allowed = impact;
+            blocked = true;
+        }
+        return false;
+    });
+
+    // Hazards overlapped by the hitbox on its way to the final position
+    FloatRect path = box;
+    if (axis == 'x') {
+        path.size.x += allowed;
+        if (sign < 0) path.position.x -= allowed;
+    } else {
+        path.size.y += allowed;
+        if (sign < 0) path.position.y -= allowed;
+    }
+    bool hurt = level.anyDangerous(path);
 
-        hitbox.setPosition(hitbox.getPosition() + Vector2f(axis == 'x' ? distance * deltaTime : 0, axis == 'y' ? distance * deltaTime : 0));
+    Vector2f movement = {axis == 'x' ? sign * allowed : 0.0f, axis == 'y' ? sign * allowed : 0.0f};
+    sprite.move(movement);
+    hitbox.move(movement);
 
+    if (hurt) {
+        kill();
+        return;
+    }
+    if (blocked) {
+        if (axis == 'x') speed.x = 0;
+        if (axis == 'y') speed.y = 0;
+    } else if (reachesEdge) {
         // Prevent out of bounds and kill player if he falls down to the bottom
-        if (hitbox.getPosition().x < 0 || hitbox.getPosition().x + hitbox.getSize().x > levelSize.x * TILE_SIZE.x 
-            || hitbox.getPosition().y < 0 || hitbox.getPosition().y + hitbox.getSize().y > levelSize.y * TILE_SIZE.y) {
-            if (axis == 'x') speed.x = 0;
-            if (axis == 'y') {
-                if (distance > 0) {
-                    kill();
-                } else {
-                    speed.y = 0;
-                }
-            }
-            return;
-        } 
-
-        // Check for collisions with level tiles before moving
-        for (int x = playerGridPositonX - 1; x <= playerGridPositonX + 1; x++) {
-            for (int y = playerGridPositonY - 1; y <= playerGridPositonY + 2; y++) {
-                if (x < 0 || y < 0 || x >= levelSize.x || y >= levelSize.y) {
-                    continue;
-                }
-                if (checkCollision(hitbox, tiles[x][y].getHitbox())) {
-                    if (tiles[x][y].isSolid()) {
-                        if (axis == 'x') speed.x = 0;
-                        if (axis == 'y') speed.y = 0;
-                        return;
-                    }
-                    if (tiles[x][y].isDangerous()) {
-                        kill();
-                        return;
-                    }
-                }
+        if (axis == 'x') speed.x = 0;
+        if (axis == 'y') {
+            if (distance > 0) {
+                kill();
+            } else {
+                speed.y = 0;
             }
         }
-
-        sprite.move({axis == 'x' ? distance * deltaTime : 0, axis == 'y' ? distance * deltaTime : 0});
-        moved -= abs(distance) * deltaTime;
     }
-
-    
-    return;
 }
 
 /**
- * Update player grounded state by checking if no tile below us is solid and colliding with the player's feet
+ * Update player grounded state by checking the distance between the player's feet and the first solid tile below
  */
-void Player::updateGroundedState(float deltaTime, std::vector<std::vector<Tile>>& tiles, Vector2u levelSize) {
-    int playerGridPositonX = hitbox.getPosition().x / TILE_SIZE.x;
-    int playerGridPositonY = hitbox.getPosition().y / TILE_SIZE.y;
-    // int y = playerGridPositonY + 2; // The range of tiles below the player is at Y + 2 because the player is 2 tiles tall
-
-    RectangleShape feetHitbox = RectangleShape(hitbox.getSize());
-    feetHitbox.setPosition(hitbox.getPosition() + Vector2f({0, 1}));
-
-    RectangleShape landingHitbox = RectangleShape(hitbox.getSize());
-    landingHitbox.setPosition(feetHitbox.getPosition() + Vector2f({0, 48}));
-
-    for (int x = playerGridPositonX - 1; x <= playerGridPositonX + 1; x++) {
-        // Check for tiles below the player's feet (starting from Y + 2)
-        for (int y = playerGridPositonY + 2; y <= playerGridPositonY + 4; y++) {
-            if (x < 0 || y < 0 || x >= levelSize.x || y >= levelSize.y) {
-                continue;
-            }
-            // Player is considered landing when he is about to hit the tile below (48 pixels margin)
-            if (speed.y >= 0 && !groundedState && tiles[x][y].isSolid() && checkCollision(landingHitbox, tiles[x][y].getHitbox())) {
-                resetAnimation();
-                landingState = true;
-            }
-            if (tiles[x][y].isSolid() && checkCollision(feetHitbox, tiles[x][y].getHitbox())) {
-                groundedState = true;
-                jumpingState = false;
-                canDash = true;
-                // Jump if the player buffered a jump while landing
-                if (!actionQueue.empty() && actionQueue.front() == Action::JUMP) {
-                    actionQueue.pop();
-                    jump();
-                }
-                return;
-            }
+void Player::updateGroundedState(const Level& level) {
+    // Player is considered landing when he is about to hit the tile below (48 pixels margin)
+    float groundDistance = level.distanceToGround(hitbox.getGlobalBounds(), 49);
+
+    if (speed.y >= 0 && !groundedState && groundDistance < 49) {
+        resetAnimation();
+        landingState = true;
+    }
+    if (groundDistance < 1) {
+        groundedState = true;
+        jumpingState = false;
+        canDash = true;
+        // Jump if the player buffered a jump while landing
+        if (!actionQueue.empty() && actionQueue.front() == Action::JUMP) {
+            actionQueue.pop();
+            jump();
         }
+        return;
     }
 
     // Keep in memory the last value of speed.x before jumping or falling off a ledge
@@ -407,37 +530,30 @@ void Player::updateHitbox() {
 }
 
 /**
- * Animate player sprite
- * Returns true when the animation is over
+ * Play a clip of the player sheet, the player switches clips without starting them over
+ * Returns true when the clip does not loop and is over
  */
-bool Player::animate(float deltaTime, float timePerFrame, int offsetX, int offsetY, int totalFrames, bool repeat) {
-    animationTimer += deltaTime;
-    totalAnimationTimer += deltaTime;
-
-    cout << totalAnimationTimer << endl;
-    
-    if (totalAnimationTimer >= totalFrames * timePerFrame) {
-        if (!repeat) {
-            cout << "animation finished" << endl;
-            return true;
-        }
-    }
-
-    if (animationTimer > timePerFrame) {
-        currentFrame = (currentFrame + 1) % totalFrames;
-        sprite.setTextureRect(IntRect({currentFrame * frameWidth + offsetX, offsetY}, {frameWidth, frameHeight}));
-        animationTimer = 0.0f;
+bool Player::animate(float deltaTime, ClipId clip) {
+    const AnimationLibrary& animations = getAnimations();
+    AnimationStep step = animations.advance(clip, currentFrame, animationTimer, totalAnimationTimer, deltaTime);
+    if (step == AnimationStep::NEW_FRAME) {
+        setFrame(animations.getFrameRect(clip, currentFrame));
     }
-
-    return false;
+    return step == AnimationStep::OVER;
 }
 
 bool Player::checkCollision(RectangleShape& hitboxA, RectangleShape& hitboxB) {
     return hitboxA.getGlobalBounds().findIntersection(hitboxB.getGlobalBounds()).has_value();
 }
 
+bool Player::checkCollision(RectangleShape& hitbox, FloatRect bounds) {
+    return hitbox.getGlobalBounds().findIntersection(bounds).has_value();
+}
+
 void Player::applyFriction(float deltaTime, float factor) {
-    cout << "friction" << endl;
+    if (DEBUG) {
+        cout << "friction" << endl;
+    }
     if (speed.x > 0) {
         speed.x -= factor * friction.x * deltaTime;
         if (speed.x < 0) {
@@ -468,7 +584,7 @@ void Player::jump() {
 }
 
 void Player::faceLeft() {
-    sprite.setOrigin({(float) frameWidth, 0});
+    sprite.setOrigin({(float) frameRect.size.x, 0});
     sprite.setScale({-1, 1});
     direction = -1;
 }
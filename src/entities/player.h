@@ -7,9 +7,11 @@ class Level;
 #include <iostream>
 #include <math.h>
 #include <queue>
-#include "../sys/tile.h"
+#include "../sys/tileMap.h"
 #include "../sys/level.h"
 #include "../sys/input.h"
+#include "../sys/gameClock.h"
+#include "../sys/animation.h"
 #include "../util/action.h"
 
 #define PLAYER_SPRITE_FILENAME "assets/entities/hooded protagonist penzilla.png"
@@ -19,25 +21,47 @@ constexpr Vector2i PLAYER_SPRITE_SIZE {256, 320};
 constexpr Vector2f HITBOX_OFFSET {10, 4};
 constexpr Vector2f HITBOX_SIZE {10, 28};
 
-#define SPRITE_OFFSET_WALKING 64
-#define SPRITE_OFFSET_RUNNING 96
-#define SPRITE_OFFSET_JUMPING 5 * 32
-#define SPRITE_OFFSET_DYING 6 * 32
-
-#define WALKING_FRAMES 4
-#define RUNNING_FRAMES 8
-
 #define MAX_SPEED_WALKING 125.0f
 #define MAX_SPEED_RUNNING 200.0f
 #define DASHING_SPEED 525.0f
 
+#define MAX_QUEUED_ACTIONS 4
+
+/**
+ * State of the player that changes during a run, plain data so it can be copied and diffed byte by byte
+ */
+struct PlayerSnapshot {
+    Vector2f spritePosition;
+    Vector2f hitboxPosition;
+    IntRect textureRect;
+    Vector2f speed;
+    float maxSpeed;
+    float airboneXSpeedSnapshot;
+    float animationTimer;
+    float totalAnimationTimer;
+    float collisionTimer;
+    int32_t health;
+    int32_t direction;
+    int32_t currentFrame;
+    bool groundedState;
+    bool dyingState;
+    bool landingState;
+    bool dashingState;
+    bool jumpingState;
+    bool canDash;
+    bool colliding;
+    uint8_t queuedActionCount;
+    Action queuedActions[MAX_QUEUED_ACTIONS];
+};
+
 
 class Player {
     private:
         int health;
         RectangleShape hitbox;
-        Texture texture;
+        const TextureAtlas* atlas = nullptr;
         Sprite sprite;
+        IntRect frameRect; // Current frame in the sprite sheet, the sprite shows it wherever the sheet is in the atlas
         Vector2f speed;
         Vector2f acceleration;
         Vector2f friction;
@@ -46,11 +70,9 @@ class Player {
         float airboneXSpeedSnapshot; 
         int direction = 1; // 1: right -1: left
 
-        int currentFrame = 0;
-        int frameWidth = 32;
-        int frameHeight = 32;
-        float animationTimer = 0.0f;
-        float totalAnimationTimer = 0.0f;
+        int32_t currentFrame = 0;
+        float animationTimer = 0.0f; // Time since the frame started
+        float totalAnimationTimer = 0.0f; // Time since the clip started
     
         bool groundedState = false;
         bool dyingState = false;
@@ -66,17 +88,21 @@ class Player {
 
         void updateHitbox();
         void applyFriction(float deltaTime, float factor);
-        void updateGroundedState(float deltaTime, std::vector<std::vector<Tile>>& tiles, Vector2u levelSize);
-        bool animate(float deltaTime, float timePerFrame, int offsetX, int offsetY, int totalFrames, bool repeat);
+        void updateGroundedState(const Level& level);
+        bool animate(float deltaTime, ClipId clip);
+        void setFrame(IntRect rect);
 
     public:
         Player(Vector2f spawnPosition);
+        void loadGraphics(const TextureAtlas& atlas);
+        void saveState(PlayerSnapshot& snapshot) const;
+        void loadState(const PlayerSnapshot& snapshot);
         RectangleShape& getHitbox();
         Sprite& getSprite();
-        void update(float deltaTime, Clock& globalClock, Level& level, Input& input);
-        void updatePosition(float deltaTime, float dx, float dy, Level& level);
-        void updatePosition2(Vector2f deltaPosition, float deltaTime, Level& level);
-        void movePlayer(float, float, char, vector<vector<Tile>>&, Vector2u levelSize);
+        void update(float deltaTime, GameClock& globalClock, const Level& level, const Input& input);
+        void updatePosition(float dx, float dy, const Level& level);
+        void updatePosition2(Vector2f deltaPosition, const Level& level);
+        void movePlayer(float distance, char axis, const Level& level);
         void resetSpeed();
         void resetAnimation();
         void faceRight();
@@ -85,6 +111,7 @@ class Player {
         void jump();
         void dash();
         bool checkCollision(RectangleShape& hitboxA, RectangleShape& hitboxB); // This one should be elsewhere probably
+        bool checkCollision(RectangleShape& hitbox, FloatRect bounds);
         
 };
 
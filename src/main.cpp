@@ -1,52 +1,115 @@
 #include <SFML/Graphics.hpp>
 #include "entities/player.h"
-#include "entities/mapEntity.h"
+#include "entities/entityWorld.h"
 #include "sys/tile.h"
 #include "sys/level.h"
 #include "util/globalConstants.h"
 #include "sys/camera.h"
 #include "sys/game.h"
 #include "sys/input.h"
+#include "sys/inputRecording.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <random>
 
-int main() {
-    Clock globalClock; // Used to know in how much time the player completed the level
-    Clock realTimeClock; // Used to update the game each frame
+/**
+ * Usage:
+ *  game                     play LEVEL_FILENAME
+ *  game --record <file>     play and save the inputs of the run to a file
+ *  game --replay <file>     watch a recorded run, the keyboard is ignored
+ *  game --stress <count>    play with thousands of extra sprites around the spawn, F1 shows how many draw calls they take
+ */
+int main(int argc, char** argv) {
+    Clock startupClock;
+    Game::prefetchAssets(LEVEL_TILESET);
+
+    unique_ptr<InputRecorder> recorder;
+    unique_ptr<InputReplay> replay;
+    string levelFilename = LEVEL_FILENAME;
+    if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        recorder = make_unique<InputRecorder>(argv[2], levelFilename, TICK_RATE);
+    } else if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        replay = make_unique<InputReplay>(argv[2]);
+        levelFilename = replay->getLevelFilename();
+        if (replay->getTickRate() != TICK_RATE) {
+            throw runtime_error("Recording was made at another tick rate");
+        }
+    }
+
+    Clock realTimeClock; // Used to know how much time the last frame took
 
     RenderWindow window(VideoMode(SCREEN_RESOLUTION), "SFML test project");
     window.setFramerateLimit(120);
     window.setKeyRepeatEnabled(false);
     
     Camera camera = Camera(SCREEN_RESOLUTION);
-    Level level = Level(LEVEL_FILENAME, LEVEL_TILESET);
+    Level level = Level(levelFilename, LEVEL_TILESET);
     Player player = Player(Vector2f(level.getSpawnPosition()));
 
     Game game = Game(player, camera, level);
+    game.loadGraphics();
+    game.setReplay(replay.get());
+    if (argc > 2 && strcmp(argv[1], "--stress") == 0) {
+        // Tutorial arrows without text scattered over the screens around the spawn, all drawn from the atlas by the sprite batch
+        Vector2f worldEnd = Vector2f(level.getSize().x * TILE_SIZE.x, level.getSize().y * TILE_SIZE.y) - Vector2f(TILE_SIZE);
+        mt19937 random(1);
+        uniform_real_distribution<float> randomOffset(-1.0f, 1.0f);
+        for (size_t i = 0; i < stoull(argv[2]); i++) {
+            Vector2f position = Vector2f(level.getSpawnPosition()) + Vector2f(randomOffset(random) * SCREEN_RESOLUTION.x, randomOffset(random) * SCREEN_RESOLUTION.y);
+            game.addEntity({MapEntityType::TUTORIAL_ARROW, {clamp(position.x, 0.0f, worldEnd.x), clamp(position.y, 0.0f, worldEnd.y)}, ""});
+        }
+    }
+    getAssetCache().releasePrefetched();
     Input input = Input();
+    bool firstFrame = true;
 
     while (window.isOpen()) {
-        float deltaTime = realTimeClock.restart().asSeconds();
+        float frameTime = realTimeClock.restart().asSeconds();
         Keyboard::Scancode keyPressed;
         Keyboard::Scancode keyReleased;
 
         while (const auto eventOpt = window.pollEvent()) {
             if (eventOpt->is<Event::Closed>()) {
                 window.close();
+            } else if (replay != nullptr) {
+                continue;
             } else if (const auto* event = eventOpt->getIf<Event::KeyPressed>()) {
                 keyPressed = event->scancode;
                 input.updateKeyPress(keyPressed);
+                if (recorder != nullptr) {
+                    recorder->recordKeyPress(game.getTickCount(), keyPressed);
+                }
             } else if (const auto* event = eventOpt->getIf<Event::KeyReleased>()) {
                 keyReleased = event->scancode;
                 input.updateKeyRelease(keyReleased);
+                if (recorder != nullptr) {
+                    recorder->recordKeyRelease(game.getTickCount(), keyReleased);
+                }
             }
         }
         
         window.clear();
     
-        game.run(deltaTime, globalClock, window, input);
-        
-        input.clear();
+        game.run(frameTime, window, input);
+        if (game.isQuitRequested() || (replay != nullptr && replay->isFinished(game.getTickCount()))) {
+            window.close();
+        }
 
         window.display();
+
+        if (firstFrame) {
+            firstFrame = false;
+            AssetCache& assets = getAssetCache();
+            cout << "First frame after " << startupClock.getElapsedTime().asMilliseconds() << "ms, " << assets.getDecodeCount() << " assets decoded in "
+                << (int) (assets.getDecodeSeconds() * 1000) << "ms (" << assets.getHitCount() << " cache hits)" << endl;
+        }
+    }
+
+    if (recorder != nullptr) {
+        recorder->finish(game.getTickCount(), game.getResult());
+        float seconds = (float) game.getTickCount() / TICK_RATE;
+        cout << "Recorded " << game.getTickCount() << " ticks in " << recorder->getBytesWritten() << " bytes (" 
+            << recorder->getBytesWritten() / max(seconds, 1.0f) << " bytes/s)" << endl;
     }
-}
\ No newline at end of file
+}
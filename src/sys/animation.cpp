@@ -0,0 +1,189 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+uint32_t Animators::add(ClipId clip) {
+    this->clip.push_back(clip);
+    frame.push_back(0);
+    frameTimer.push_back(0.0f);
+    clipTimer.push_back(0.0f);
+    finished.push_back(false);
+    return this->clip.size() - 1;
+}
+
+size_t Animators::size() const {
+    return clip.size();
+}
+
+AtlasRegion parseRegion(const string& name) {
+    const pair<const char*, AtlasRegion> regions[] = {
+        {"tileset", AtlasRegion::TILESET}, {"background", AtlasRegion::BACKGROUND}, {"player", AtlasRegion::PLAYER},
+        {"tutorial_arrow", AtlasRegion::TUTORIAL_ARROW}, {"sacred_fruit", AtlasRegion::SACRED_FRUIT}
+    };
+    for (const auto& region : regions) {
+        if (name == region.first) {
+            return region.second;
+        }
+    }
+    throw runtime_error("Unknown clip image " + name);
+}
+
+AnimationLibrary::AnimationLibrary() {}
+
+/**
+ * Read a clip file, one definition per line, # starts a comment:
+ *  clip <name> <image> <x> <y> <frame width> <frame height> <frames> <seconds per frame> <loop|once>
+ *  offset <clip> <frame> <x> <y>       move the sprite while the frame is shown
+ *  event <clip> <frame> <name>         fire an event when an animator moves to the frame
+ * Frames of a clip are side by side from x y, lines about a clip come after the clip
+ */
+AnimationLibrary::AnimationLibrary(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open clip file " + filename);
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        istringstream iss(line.substr(0, line.find('#')));
+        string keyword;
+        if (!(iss >> keyword)) {
+            continue;
+        }
+
+        if (keyword == "clip") {
+            AnimationClip clip;
+            string region, mode;
+            Vector2i origin, size;
+            if (!(iss >> clip.name >> region >> origin.x >> origin.y >> size.x >> size.y >> clip.frameCount >> clip.frameDuration >> mode)
+                || clip.frameCount == 0 || (mode != "loop" && mode != "once")) {
+                throw runtime_error("Malformed clip at line " + to_string(lineNumber) + " of " + filename);
+            }
+            clip.region = parseRegion(region);
+            clip.loop = mode == "loop";
+            clip.duration = clip.frameCount * clip.frameDuration;
+            clip.firstFrame = frameRects.size();
+            clip.firstEvent = events.size();
+            clip.eventCount = 0;
+            for (int frame = 0; frame < clip.frameCount; frame++) {
+                frameRects.push_back(IntRect({origin.x + frame * size.x, origin.y}, size));
+                frameOffsets.push_back({0, 0});
+            }
+            clips.push_back(clip);
+            continue;
+        }
+
+        string clipName;
+        int frame;
+        if (!(iss >> clipName >> frame)) {
+            throw runtime_error("Malformed line " + to_string(lineNumber) + " of " + filename);
+        }
+        // Offsets and events go right after their clip so its events stay contiguous
+        if (clips.empty() || clips.back().name != clipName || frame < 0 || frame >= clips.back().frameCount) {
+            throw runtime_error("Line " + to_string(lineNumber) + " of " + filename + " is not about a frame of the clip above it");
+        }
+        AnimationClip& clip = clips.back();
+
+        if (keyword == "offset") {
+            Vector2f offset;
+            if (!(iss >> offset.x >> offset.y)) {
+                throw runtime_error("Malformed offset at line " + to_string(lineNumber) + " of " + filename);
+            }
+            frameOffsets[clip.firstFrame + frame] = offset;
+        } else if (keyword == "event") {
+            string name;
+            if (!(iss >> name)) {
+                throw runtime_error("Malformed event at line " + to_string(lineNumber) + " of " + filename);
+            }
+            uint16_t nameIndex = std::find(eventNames.begin(), eventNames.end(), name) - eventNames.begin();
+            if (nameIndex == eventNames.size()) {
+                eventNames.push_back(name);
+            }
+            events.push_back({(uint16_t) frame, nameIndex});
+            clip.eventCount++;
+        } else {
+            throw runtime_error("Unknown keyword " + keyword + " at line " + to_string(lineNumber) + " of " + filename);
+        }
+    }
+}
+
+/**
+ * Index of a clip, looked up once by whoever plays it
+ */
+ClipId AnimationLibrary::find(string_view name) const {
+    for (size_t i = 0; i < clips.size(); i++) {
+        if (clips[i].name == name) {
+            return i;
+        }
+    }
+    throw runtime_error("Unknown animation clip " + string(name));
+}
+
+const AnimationClip& AnimationLibrary::getClip(ClipId clip) const {
+    return clips[clip];
+}
+
+size_t AnimationLibrary::getClipCount() const {
+    return clips.size();
+}
+
+IntRect AnimationLibrary::getFrameRect(ClipId clip, int frame) const {
+    return frameRects[clips[clip].firstFrame + frame];
+}
+
+Vector2f AnimationLibrary::getFrameOffset(ClipId clip, int frame) const {
+    return frameOffsets[clips[clip].firstFrame + frame];
+}
+
+const string& AnimationLibrary::getEventName(uint16_t name) const {
+    return eventNames[name];
+}
+
+/**
+ * Advance every animator that is not finished, the events of the frames they move to are appended to fired
+ */
+void AnimationLibrary::update(Animators& animators, float deltaTime, vector<FiredEvent>* fired) const {
+    const ClipId* clip = animators.clip.data();
+    int32_t* frame = animators.frame.data();
+    float* frameTimer = animators.frameTimer.data();
+    float* clipTimer = animators.clipTimer.data();
+    uint8_t* finished = animators.finished.data();
+    for (size_t i = 0; i < animators.size(); i++) {
+        if (finished[i]) {
+            continue;
+        }
+        AnimationStep step = advance(clip[i], frame[i], frameTimer[i], clipTimer[i], deltaTime);
+        if (step == AnimationStep::OVER) {
+            finished[i] = true;
+        } else if (step == AnimationStep::NEW_FRAME && fired != nullptr) {
+            const AnimationClip& definition = clips[clip[i]];
+            for (uint32_t event = definition.firstEvent; event < definition.firstEvent + definition.eventCount; event++) {
+                if (events[event].frame == frame[i]) {
+                    fired->push_back({(uint32_t) i, events[event].name});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Jump a looping clip ahead by the time an animator was not updated, like advancing it tick by tick without the rounding
+ */
+void AnimationLibrary::catchUp(ClipId clip, int32_t& frame, float& frameTimer, float elapsed) const {
+    const AnimationClip& definition = clips[clip];
+    int steps = (frameTimer + elapsed) / definition.frameDuration;
+    frameTimer = fmod(frameTimer + elapsed, definition.frameDuration);
+    frame = (frame + steps) % definition.frameCount;
+}
+
+/**
+ * Clips of the whole game, read the first time they are needed and shared by every animator
+ */
+const AnimationLibrary& getAnimations() {
+    static AnimationLibrary library(ANIMATIONS_FILENAME);
+    return library;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "textureAtlas.h"
+
+using namespace std;
+using namespace sf;
+
+#define ANIMATIONS_FILENAME "assets/animations/clips.anim"
+
+typedef uint16_t ClipId; // Index of the clip in the library
+
+/**
+ * Sequence of frames of the same size, side by side in one image
+ * The frames, their offsets and their events are ranges of the tables of the library
+ */
+struct AnimationClip {
+    string name;
+    AtlasRegion region; // Image the frames are in
+    uint32_t firstFrame;
+    uint16_t frameCount;
+    float frameDuration;
+    float duration; // A clip that does not loop is over once it played this long
+    bool loop;
+    uint32_t firstEvent;
+    uint16_t eventCount;
+};
+
+/**
+ * Named event of a clip, fired when an animator moves to its frame
+ */
+struct ClipEvent {
+    uint16_t frame;
+    uint16_t name; // Index in the event names of the library
+};
+
+enum class AnimationStep : uint8_t {
+    PLAYING,
+    NEW_FRAME, // The animator moved to the next frame
+    OVER // The clip does not loop and played for its whole duration
+};
+
+struct FiredEvent {
+    uint32_t animator;
+    uint16_t name;
+};
+
+/**
+ * Playback state of many animators, one array per field so advancing them all is a single pass over contiguous memory
+ */
+struct Animators {
+    vector<ClipId> clip;
+    vector<int32_t> frame;
+    vector<float> frameTimer; // Time since the frame started
+    vector<float> clipTimer; // Time since the clip started
+    vector<uint8_t> finished; // The clip does not loop and is over
+
+    uint32_t add(ClipId clip);
+    size_t size() const;
+};
+
+/**
+ * Every clip of the game, read once from a clip file and shared by all the animators
+ * Frame rectangles are computed when the file is read, animators only keep an index in the tables
+ */
+class AnimationLibrary {
+    private:
+        vector<AnimationClip> clips;
+        vector<IntRect> frameRects; // In the image of the clip, not in the atlas
+        vector<Vector2f> frameOffsets; // Sprite displacement on each frame
+        vector<ClipEvent> events;
+        vector<string> eventNames;
+
+    public:
+        AnimationLibrary();
+        AnimationLibrary(const string& filename);
+        ClipId find(string_view name) const;
+        const AnimationClip& getClip(ClipId clip) const;
+        size_t getClipCount() const;
+        IntRect getFrameRect(ClipId clip, int frame) const;
+        Vector2f getFrameOffset(ClipId clip, int frame) const;
+        const string& getEventName(uint16_t name) const;
+        AnimationStep advance(ClipId clip, int32_t& frame, float& frameTimer, float& clipTimer, float deltaTime) const;
+        void update(Animators& animators, float deltaTime, vector<FiredEvent>* fired = nullptr) const;
+        void catchUp(ClipId clip, int32_t& frame, float& frameTimer, float elapsed) const;
+};
+
+const AnimationLibrary& getAnimations();
+
+/**
+ * Advance one animator playing a clip
+ * The frame only moves once its duration is exceeded, then its timer starts again from 0
+ * A clip can be switched between two calls: the frame goes on from its current index, wrapped to the new clip
+ */
+inline AnimationStep AnimationLibrary::advance(ClipId clip, int32_t& frame, float& frameTimer, float& clipTimer, float deltaTime) const {
+    const AnimationClip& definition = clips[clip];
+    frameTimer += deltaTime;
+    clipTimer += deltaTime;
+    if (!definition.loop && clipTimer >= definition.duration) {
+        return AnimationStep::OVER;
+    }
+    if (frameTimer > definition.frameDuration) {
+        frame = (frame + 1) % definition.frameCount;
+        frameTimer = 0.0f;
+        return AnimationStep::NEW_FRAME;
+    }
+    return AnimationStep::PLAYING;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "assetCache.h"
+#include <algorithm>
+#include <chrono>
+
+AssetHandle::AssetHandle() {}
+
+AssetHandle::AssetHandle(AssetCache* cache, shared_ptr<Asset> asset) : cache(cache), asset(asset) {}
+
+bool AssetHandle::isLoaded() const {
+    return asset != nullptr;
+}
+
+bool AssetHandle::isReady() const {
+    lock_guard<mutex> lock(cache->cacheMutex);
+    return asset->state == Asset::State::READY;
+}
+
+const string& AssetHandle::getPath() const {
+    return asset->path;
+}
+
+const Image& AssetHandle::getImage() const {
+    cache->wait(*asset);
+    return asset->image;
+}
+
+/**
+ * Texture of an image asset, uploaded on first use so it has to be called from the thread drawing
+ */
+const Texture& AssetHandle::getTexture() const {
+    cache->wait(*asset);
+    if (!asset->uploaded) {
+        if (!asset->texture.loadFromImage(asset->image)) {
+            throw runtime_error("Failed to upload " + asset->path);
+        }
+        asset->uploaded = true;
+    }
+    return asset->texture;
+}
+
+const Font& AssetHandle::getFont() const {
+    cache->wait(*asset);
+    return asset->font;
+}
+
+AssetCache::AssetCache(size_t threadCount) {
+    for (size_t i = 0; i < max<size_t>(1, threadCount); i++) {
+        decoders.emplace_back(&AssetCache::decoderLoop, this);
+    }
+}
+
+AssetCache::~AssetCache() {
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (thread& decoder : decoders) {
+        decoder.join();
+    }
+}
+
+/**
+ * Background thread, decode queued assets one by one
+ */
+void AssetCache::decoderLoop() {
+    unique_lock<mutex> lock(cacheMutex);
+    while (true) {
+        queueCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+        shared_ptr<Asset> asset = queue.front();
+        queue.pop_front();
+        asset->state = Asset::State::DECODING;
+
+        lock.unlock();
+        decode(*asset);
+        lock.lock();
+        decodedCondition.notify_all();
+    }
+}
+
+/**
+ * Read and decode the file of an asset, the state is set with the lock held
+ */
+void AssetCache::decode(Asset& asset) {
+    auto start = chrono::steady_clock::now();
+    bool decoded = asset.type == AssetType::FONT ? asset.font.openFromFile(asset.path) : asset.image.loadFromFile(asset.path);
+    decodeMicroseconds += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    decodeCount++;
+
+    lock_guard<mutex> lock(cacheMutex);
+    asset.state = decoded ? Asset::State::READY : Asset::State::FAILED;
+}
+
+/**
+ * Block until an asset is decoded, decoding it right away when no thread has started on it
+ */
+void AssetCache::wait(Asset& asset) {
+    unique_lock<mutex> lock(cacheMutex);
+    if (asset.state == Asset::State::QUEUED) {
+        queue.erase(find_if(queue.begin(), queue.end(), [&](const shared_ptr<Asset>& queued) { return queued.get() == &asset; }));
+        asset.state = Asset::State::DECODING;
+        lock.unlock();
+        decode(asset);
+        lock.lock();
+        decodedCondition.notify_all();
+    }
+    decodedCondition.wait(lock, [&] { return asset.state == Asset::State::READY || asset.state == Asset::State::FAILED; });
+    if (asset.state == Asset::State::FAILED) {
+        throw runtime_error("Failed to load " + asset.path);
+    }
+}
+
+/**
+ * Get an asset, queued for decoding unless it is already in the cache
+ */
+AssetHandle AssetCache::load(const string& path, AssetType type) {
+    shared_ptr<Asset> asset;
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto found = assets.find(path);
+        if (found != assets.end() && (asset = found->second.lock()) != nullptr) {
+            hitCount++;
+            return AssetHandle(this, asset);
+        }
+        asset = make_shared<Asset>();
+        asset->path = path;
+        asset->type = type;
+        assets[path] = asset;
+        queue.push_back(asset);
+    }
+    queueCondition.notify_one();
+    return AssetHandle(this, asset);
+}
+
+/**
+ * Start decoding an asset that will be needed soon (the next level), the cache keeps it until releasePrefetched()
+ */
+void AssetCache::prefetch(const string& path, AssetType type) {
+    AssetHandle handle = load(path, type);
+    lock_guard<mutex> lock(cacheMutex);
+    prefetched.push_back(handle.asset);
+}
+
+/**
+ * Stop keeping the prefetched assets, the ones nothing uses are freed
+ */
+void AssetCache::releasePrefetched() {
+    lock_guard<mutex> lock(cacheMutex);
+    prefetched.clear();
+}
+
+/**
+ * Wait for every queued asset to be decoded
+ */
+void AssetCache::waitAll() {
+    vector<shared_ptr<Asset>> pending;
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        for (auto& entry : assets) {
+            if (shared_ptr<Asset> asset = entry.second.lock()) {
+                pending.push_back(asset);
+            }
+        }
+    }
+    for (shared_ptr<Asset>& asset : pending) {
+        try {
+            wait(*asset);
+        } catch (const exception&) {
+            // Reported to whoever uses the asset
+        }
+    }
+}
+
+size_t AssetCache::getDecodeCount() const {
+    return decodeCount;
+}
+
+size_t AssetCache::getHitCount() const {
+    return hitCount;
+}
+
+double AssetCache::getDecodeSeconds() const {
+    return decodeMicroseconds / 1e6;
+}
+
+/**
+ * Number of assets still used by someone, forgets the others
+ */
+size_t AssetCache::getLiveAssetCount() {
+    lock_guard<mutex> lock(cacheMutex);
+    for (auto entry = assets.begin(); entry != assets.end();) {
+        entry = entry->second.expired() ? assets.erase(entry) : next(entry);
+    }
+    return assets.size();
+}
+
+/**
+ * Cache shared by the whole program, its decoder threads start with the first asset
+ */
+AssetCache& getAssetCache() {
+    static AssetCache cache;
+    return cache;
+}
+
+/**
+ * Font of every text of the game, loaded once and kept for the whole run
+ */
+const Font& getGameFont() {
+    static AssetHandle font = getAssetCache().load(GAME_FONT_FILENAME, AssetType::FONT);
+    return font.getFont();
+}
+
+/**
+ * Empty texture for sprites built before their real texture is loaded
+ */
+const Texture& getPlaceholderTexture() {
+    static Texture texture;
+    return texture;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace sf;
+
+#define ASSET_DECODE_THREADS 2
+
+#define GAME_FONT_FILENAME "assets/fonts/VCR_OSD_MONO_1.001.ttf"
+
+enum class AssetType : uint8_t { IMAGE, FONT };
+
+/**
+ * A decoded file, images are uploaded to a texture the first time the texture is asked for
+ */
+struct Asset {
+    enum class State : uint8_t { QUEUED, DECODING, READY, FAILED };
+
+    string path;
+    AssetType type;
+    State state = State::QUEUED; // Protected by the mutex of the cache
+    Image image;
+    Font font;
+    Texture texture; // Only touched by the thread drawing
+    bool uploaded = false;
+};
+
+class AssetCache;
+
+/**
+ * Shared reference to an asset of the cache, the asset is freed when its last handle goes away
+ * The getters wait for the asset to be decoded and throw if it could not be
+ */
+class AssetHandle {
+    private:
+        friend class AssetCache;
+
+        AssetCache* cache = nullptr;
+        shared_ptr<Asset> asset;
+
+    public:
+        AssetHandle();
+        AssetHandle(AssetCache* cache, shared_ptr<Asset> asset);
+        bool isLoaded() const;
+        bool isReady() const;
+        const string& getPath() const;
+        const Image& getImage() const;
+        const Texture& getTexture() const;
+        const Font& getFont() const;
+};
+
+/**
+ * Files decoded once and shared, keyed by path
+ * Decoding happens on background threads: load() returns right away and the handle waits when the asset is first used,
+ * an asset still waiting in the queue when it is needed is decoded by the thread asking for it
+ */
+class AssetCache {
+    private:
+        friend class AssetHandle;
+
+        unordered_map<string, weak_ptr<Asset>> assets; // Weak so the cache does not keep unused assets alive
+        vector<shared_ptr<Asset>> prefetched;
+        deque<shared_ptr<Asset>> queue;
+        vector<thread> decoders;
+        mutex cacheMutex;
+        condition_variable queueCondition;
+        condition_variable decodedCondition;
+        bool stopping = false;
+
+        atomic<size_t> decodeCount{0};
+        atomic<size_t> hitCount{0};
+        atomic<uint64_t> decodeMicroseconds{0};
+
+        void decoderLoop();
+        void decode(Asset& asset);
+        void wait(Asset& asset);
+
+    public:
+        AssetCache(size_t threadCount = ASSET_DECODE_THREADS);
+        ~AssetCache();
+        AssetHandle load(const string& path, AssetType type = AssetType::IMAGE);
+        void prefetch(const string& path, AssetType type = AssetType::IMAGE);
+        void releasePrefetched();
+        void waitAll();
+        size_t getDecodeCount() const;
+        size_t getHitCount() const;
+        double getDecodeSeconds() const;
+        size_t getLiveAssetCount();
+};
+
+AssetCache& getAssetCache();
+const Font& getGameFont();
+const Texture& getPlaceholderTexture();
+
+#endif
\ No newline at end of file
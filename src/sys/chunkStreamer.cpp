@@ -0,0 +1,195 @@
+#include "chunkStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+ChunkStreamer::ChunkStreamer(string filename, ObjectPool<TileChunk>& chunkPool, size_t residencyBudget) 
+    : file(filename), chunkPool(&chunkPool), residencyBudget(residencyBudget) {
+    view = viewBinaryLevel(file.getData(), file.getSize());
+
+    size_t chunkCount = (size_t) view.chunkCount.x * view.chunkCount.y;
+    states = vector<ChunkState>(chunkCount, ChunkState::UNLOADED);
+    lastUsedFrame = vector<uint32_t>(chunkCount, 0);
+    pinned = vector<bool>(chunkCount, false);
+
+    loader = thread(&ChunkStreamer::loaderLoop, this);
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    {
+        lock_guard<mutex> lock(loaderMutex);
+        stopping = true;
+    }
+    loaderCondition.notify_one();
+    loader.join();
+}
+
+const LevelFileView& ChunkStreamer::getView() const {
+    return view;
+}
+
+void ChunkStreamer::setResidencyBudget(size_t residencyBudget) {
+    this->residencyBudget = residencyBudget;
+}
+
+/**
+ * Background thread, load requested chunks one by one
+ */
+void ChunkStreamer::loaderLoop() {
+    unique_lock<mutex> lock(loaderMutex);
+    while (true) {
+        loaderCondition.wait(lock, [this] { return stopping || !requests.empty(); });
+        if (stopping) {
+            return;
+        }
+        int index = requests.front();
+        requests.pop_front();
+
+        lock.unlock();
+        ChunkPointer chunk = loadChunk(index);
+        lock.lock();
+
+        completed.push_back({index, move(chunk)});
+    }
+}
+
+/**
+ * Copy a chunk out of the mapped file, this is where the page faults happen
+ */
+ChunkPointer ChunkStreamer::loadChunk(int index) const {
+    ChunkPointer chunk = chunkPool->acquire();
+    memcpy(chunk->tileTypes, view.chunks[index].tileTypes, sizeof(chunk->tileTypes));
+    memcpy(chunk->backgroundTileTypes, view.chunks[index].backgroundTileTypes, sizeof(chunk->backgroundTileTypes));
+    chunk->computeFlags();
+    return chunk;
+}
+
+/**
+ * Range of chunks covering a region in pixels, extended by a margin of chunks and clamped to the level
+ */
+IntRect ChunkStreamer::getChunkRange(FloatRect region, int margin) const {
+    Vector2i chunkPixelSize = {CHUNK_SIZE * (int) TILE_SIZE.x, CHUNK_SIZE * (int) TILE_SIZE.y};
+    int startX = max(0, (int) floor(region.position.x / chunkPixelSize.x) - margin);
+    int startY = max(0, (int) floor(region.position.y / chunkPixelSize.y) - margin);
+    int endX = min((int) view.chunkCount.x - 1, (int) floor((region.position.x + region.size.x) / chunkPixelSize.x) + margin);
+    int endY = min((int) view.chunkCount.y - 1, (int) floor((region.position.y + region.size.y) / chunkPixelSize.y) + margin);
+    return IntRect({startX, startY}, {endX - startX + 1, endY - startY + 1});
+}
+
+/**
+ * Synchronously load the chunks around a region and pin them so they are never evicted (used for the spawn area)
+ */
+void ChunkStreamer::prime(TileMap& tiles, FloatRect region, vector<int>& installed) {
+    IntRect range = getChunkRange(region, CHUNK_STREAMING_MARGIN);
+    for (int chunkY = range.position.y; chunkY < range.position.y + range.size.y; chunkY++) {
+        for (int chunkX = range.position.x; chunkX < range.position.x + range.size.x; chunkX++) {
+            int index = chunkX + chunkY * view.chunkCount.x;
+            pinned[index] = true;
+            if (states[index] == ChunkState::UNLOADED) {
+                tiles.setChunk(index, loadChunk(index));
+                states[index] = ChunkState::RESIDENT;
+                installed.push_back(index);
+            }
+        }
+    }
+}
+
+/**
+ * Synchronously load the chunks of a region that are not resident yet, including the ones waiting for the loader
+ * Used for the area the simulation reads, so its result never depends on how fast the loader thread is
+ * Only the chunks the region touches are loaded, the loader is normally ahead since update() requests a wider margin
+ */
+void ChunkStreamer::require(TileMap& tiles, FloatRect region, vector<int>& installed) {
+    IntRect range = getChunkRange(region, 0);
+    size_t first = installed.size();
+    {
+        lock_guard<mutex> lock(loaderMutex);
+        for (int chunkY = range.position.y; chunkY < range.position.y + range.size.y; chunkY++) {
+            for (int chunkX = range.position.x; chunkX < range.position.x + range.size.x; chunkX++) {
+                int index = chunkX + chunkY * view.chunkCount.x;
+                lastUsedFrame[index] = frame;
+                if (states[index] != ChunkState::RESIDENT) {
+                    requests.erase(remove(requests.begin(), requests.end(), index), requests.end());
+                    installed.push_back(index);
+                }
+            }
+        }
+    }
+
+    // The loader only reads the requests, so the chunks are copied without holding it up
+    for (size_t i = first; i < installed.size(); i++) {
+        tiles.setChunk(installed[i], loadChunk(installed[i]));
+        states[installed[i]] = ChunkState::RESIDENT;
+        synchronousLoads++;
+    }
+}
+
+/**
+ * Install the chunks loaded since the last call, request the missing ones around the region 
+ * and pick the least recently used chunks over the residency budget for eviction
+ * Evicted chunks are still in the TileMap when this returns, the caller releases them
+ */
+void ChunkStreamer::update(TileMap& tiles, FloatRect region, vector<int>& installed, vector<int>& evicted) {
+    frame++;
+    IntRect range = getChunkRange(region, CHUNK_STREAMING_MARGIN);
+
+    {
+        lock_guard<mutex> lock(loaderMutex);
+
+        for (LoadedChunk& loaded : completed) {
+            // Already loaded by require() while the loader was working on it
+            if (states[loaded.index] == ChunkState::RESIDENT) {
+                continue;
+            }
+            tiles.setChunk(loaded.index, move(loaded.chunk));
+            states[loaded.index] = ChunkState::RESIDENT;
+            installed.push_back(loaded.index);
+        }
+        completed.clear();
+
+        // Drop requests that left the region before the loader got to them
+        for (int index : requests) {
+            states[index] = ChunkState::UNLOADED;
+        }
+        requests.clear();
+
+        for (int chunkY = range.position.y; chunkY < range.position.y + range.size.y; chunkY++) {
+            for (int chunkX = range.position.x; chunkX < range.position.x + range.size.x; chunkX++) {
+                int index = chunkX + chunkY * view.chunkCount.x;
+                lastUsedFrame[index] = frame;
+                if (states[index] == ChunkState::UNLOADED) {
+                    states[index] = ChunkState::QUEUED;
+                    requests.push_back(index);
+                }
+            }
+        }
+    }
+    loaderCondition.notify_one();
+
+    // Evict the least recently used chunks, chunks in the current region and pinned chunks are kept
+    const vector<int>& residentChunks = tiles.getResidentChunks();
+    if (residentChunks.size() <= residencyBudget) {
+        return;
+    }
+
+    vector<int> candidates;
+    for (int index : residentChunks) {
+        if (lastUsedFrame[index] != frame && !pinned[index]) {
+            candidates.push_back(index);
+        }
+    }
+    sort(candidates.begin(), candidates.end(), [this](int a, int b) { return lastUsedFrame[a] < lastUsedFrame[b]; });
+
+    size_t excess = min(residentChunks.size() - residencyBudget, candidates.size());
+    for (size_t i = 0; i < excess; i++) {
+        states[candidates[i]] = ChunkState::UNLOADED;
+        evicted.push_back(candidates[i]);
+    }
+}
+
+/**
+ * Chunks the simulation had to load itself because the loader was behind
+ */
+size_t ChunkStreamer::getSynchronousLoads() const {
+    return synchronousLoads;
+}
\ No newline at end of file
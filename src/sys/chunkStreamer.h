@@ -0,0 +1,70 @@
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tileMap.h"
+#include "levelFile.h"
+#include "../util/mappedFile.h"
+
+using namespace std;
+using namespace sf;
+
+#define CHUNK_RESIDENCY_BUDGET 64 // Default number of chunks kept in memory
+#define CHUNK_STREAMING_MARGIN 2 // Chunks requested around the streamed region, so the loader is ahead of the simulation
+
+/**
+ * Pages the chunks of a compiled level in and out of a TileMap around a region of interest
+ * 
+ * Chunks are read from the mapped file by a background thread, the TileMap itself is only modified 
+ * on the calling thread in update() so collision queries never wait for the loader
+ * require() is the fallback when the loader falls behind, its synchronous loads are counted
+ */
+class ChunkStreamer {
+    private:
+        enum class ChunkState : uint8_t { UNLOADED, QUEUED, RESIDENT };
+
+        struct LoadedChunk {
+            int index;
+            ChunkPointer chunk;
+        };
+
+        MappedFile file;
+        LevelFileView view;
+        ObjectPool<TileChunk>* chunkPool;
+        size_t residencyBudget;
+
+        vector<ChunkState> states;
+        vector<uint32_t> lastUsedFrame;
+        vector<bool> pinned;
+        uint32_t frame = 0;
+
+        thread loader;
+        mutex loaderMutex;
+        condition_variable loaderCondition;
+        deque<int> requests;
+        vector<LoadedChunk> completed;
+        bool stopping = false;
+        size_t synchronousLoads = 0;
+
+        void loaderLoop();
+        ChunkPointer loadChunk(int index) const;
+        IntRect getChunkRange(FloatRect region, int margin) const;
+
+    public:
+        ChunkStreamer(string filename, ObjectPool<TileChunk>& chunkPool, size_t residencyBudget = CHUNK_RESIDENCY_BUDGET);
+        ~ChunkStreamer();
+        const LevelFileView& getView() const;
+        void setResidencyBudget(size_t residencyBudget);
+        void prime(TileMap& tiles, FloatRect region, vector<int>& installed);
+        void require(TileMap& tiles, FloatRect region, vector<int>& installed);
+        void update(TileMap& tiles, FloatRect region, vector<int>& installed, vector<int>& evicted);
+        size_t getSynchronousLoads() const;
+};
+
+#endif
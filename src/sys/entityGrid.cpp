@@ -0,0 +1,83 @@
+#include "entityGrid.h"
+#include <algorithm>
+#include <cmath>
+
+EntityGrid::EntityGrid() : EntityGrid(Vector2f(ENTITY_CELL_SIZE, ENTITY_CELL_SIZE)) {}
+
+EntityGrid::EntityGrid(Vector2f worldSize) {
+    cellCount = Vector2i(max(1, (int) ceil(worldSize.x / ENTITY_CELL_SIZE)), max(1, (int) ceil(worldSize.y / ENTITY_CELL_SIZE)));
+    cells = vector<vector<uint32_t>>(cellCount.x * cellCount.y);
+}
+
+/**
+ * Cells touched by a rectangle, clamped to the grid so entities outside the level end up in the border cells
+ */
+IntRect EntityGrid::getCellRange(FloatRect bounds) const {
+    int startX = min(max((int) floor(bounds.position.x / ENTITY_CELL_SIZE), 0), cellCount.x - 1);
+    int startY = min(max((int) floor(bounds.position.y / ENTITY_CELL_SIZE), 0), cellCount.y - 1);
+    int endX = min(max((int) floor((bounds.position.x + bounds.size.x) / ENTITY_CELL_SIZE), 0), cellCount.x - 1);
+    int endY = min(max((int) floor((bounds.position.y + bounds.size.y) / ENTITY_CELL_SIZE), 0), cellCount.y - 1);
+    return IntRect({startX, startY}, {endX - startX + 1, endY - startY + 1});
+}
+
+void EntityGrid::addToCells(uint32_t entity, IntRect range) {
+    for (int y = range.position.y; y < range.position.y + range.size.y; y++) {
+        for (int x = range.position.x; x < range.position.x + range.size.x; x++) {
+            cells[y * cellCount.x + x].push_back(entity);
+        }
+    }
+}
+
+void EntityGrid::removeFromCells(uint32_t entity, IntRect range) {
+    for (int y = range.position.y; y < range.position.y + range.size.y; y++) {
+        for (int x = range.position.x; x < range.position.x + range.size.x; x++) {
+            vector<uint32_t>& cell = cells[y * cellCount.x + x];
+            auto found = find(cell.begin(), cell.end(), entity);
+            if (found != cell.end()) {
+                *found = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+/**
+ * Add an entity, returns its identifier which is the number of entities inserted before it
+ */
+uint32_t EntityGrid::insert(FloatRect bounds) {
+    uint32_t entity = entityBounds.size();
+    entityBounds.push_back(bounds);
+    entityCells.push_back(getCellRange(bounds));
+    addToCells(entity, entityCells.back());
+    return entity;
+}
+
+/**
+ * Update the bounds of an entity, the cells are only touched when it moved to other cells
+ */
+void EntityGrid::move(uint32_t entity, FloatRect bounds) {
+    entityBounds[entity] = bounds;
+    IntRect range = getCellRange(bounds);
+    if (range == entityCells[entity]) {
+        return;
+    }
+    removeFromCells(entity, entityCells[entity]);
+    addToCells(entity, range);
+    entityCells[entity] = range;
+}
+
+void EntityGrid::clear() {
+    for (vector<uint32_t>& cell : cells) {
+        cell.clear();
+    }
+    entityBounds.clear();
+    entityCells.clear();
+}
+
+FloatRect EntityGrid::getBounds(uint32_t entity) const {
+    return entityBounds[entity];
+}
+
+size_t EntityGrid::getEntityCount() const {
+    return entityBounds.size();
+}
@@ -0,0 +1,64 @@
+#ifndef ENTITY_GRID_H
+#define ENTITY_GRID_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+using namespace sf;
+
+#define ENTITY_CELL_SIZE 64.0f // 4x4 tiles, a few times the size of an entity
+
+/**
+ * Uniform grid over the level telling which entities are in each cell, so overlap queries only look at nearby entities
+ * Entities are identified by their index in the game, and listed in every cell their bounds touch
+ */
+class EntityGrid {
+    private:
+        Vector2i cellCount;
+        vector<vector<uint32_t>> cells;
+        vector<FloatRect> entityBounds;
+        vector<IntRect> entityCells; // Cells covered by each entity
+
+        IntRect getCellRange(FloatRect bounds) const;
+        void addToCells(uint32_t entity, IntRect range);
+        void removeFromCells(uint32_t entity, IntRect range);
+
+    public:
+        EntityGrid();
+        EntityGrid(Vector2f worldSize);
+        uint32_t insert(FloatRect bounds);
+        void move(uint32_t entity, FloatRect bounds);
+        void clear();
+        FloatRect getBounds(uint32_t entity) const;
+        size_t getEntityCount() const;
+        template <typename Callback> int query(FloatRect area, Callback callback) const;
+};
+
+/**
+ * Call callback(entity) for every entity whose bounds overlap an area (empty intersections do not count)
+ * An entity spanning several cells is only reported by the first cell it shares with the area
+ * Returns the number of entities tested
+ */
+template <typename Callback> int EntityGrid::query(FloatRect area, Callback callback) const {
+    int tested = 0;
+    IntRect range = getCellRange(area);
+    for (int y = range.position.y; y < range.position.y + range.size.y; y++) {
+        for (int x = range.position.x; x < range.position.x + range.size.x; x++) {
+            for (uint32_t entity : cells[y * cellCount.x + x]) {
+                const IntRect& covered = entityCells[entity];
+                if (x != max(covered.position.x, range.position.x) || y != max(covered.position.y, range.position.y)) {
+                    continue;
+                }
+                tested++;
+                if (entityBounds[entity].findIntersection(area).has_value()) {
+                    callback(entity);
+                }
+            }
+        }
+    }
+    return tested;
+}
+
+#endif
@@ -1,89 +1,423 @@
 #include "game.h"
+#include <cstring>
 
-string precision(float number, int n) {
-    int decimalPart = (number * pow(10, n)) - ((int)number * pow(10, n));
-    int numberPart = (int)number;
+Game::Game(Player& player, Camera& camera, Level& level) 
+    : player(player), camera(camera), level(&level), globalClock(TICK_RATE), 
+    rewindBuffer(REWIND_BUFFER_BYTES, REWIND_MAX_SECONDS * TICK_RATE) {
+    timerText = hud.addText("", {0, 0}, HUD_TIMER_CAPACITY, 1.0f, Color::White, true);
+    finishedText = hud.addText("", {SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2}, HUD_TIMER_CAPACITY, 50.0f / HUD_CHARACTER_SIZE, Color::White, true);
+    hud.setOrigin(finishedText, {0.5f, 0.5f});
+    hud.setVisible(finishedText, false);
+    statsText = hud.addText("", {SCREEN_RESOLUTION.x, 0}, HUD_STATS_CAPACITY, 0.5f);
+    hud.setOrigin(statsText, {1.0f, 0.0f});
+    pauseMenu.addToHud(hud);
+    previousPlayerPosition = player.getSprite().getPosition();
+    previousCameraCenter = camera.getView().getCenter();
+    setLevel(level);
+}
 
-    string numberString = numberPart >= 10 ? to_string(numberPart) : "0" + to_string(numberPart);
-    string decimalString = decimalPart >= 10 ? to_string(decimalPart) : "0" + to_string(decimalPart);
-    return numberString + "." + decimalString;
+/**
+ * Start decoding every image and font the game draws, so they are ready or close to it when the game needs them
+ */
+void Game::prefetchAssets(string tilesetFilename) {
+    Level::prefetchAssets(tilesetFilename);
+    getAssetCache().prefetch(PLAYER_SPRITE_FILENAME);
+    getAssetCache().prefetch(TUTORIAL_ARROW_FILENAME);
+    getAssetCache().prefetch(SACRED_FRUIT_FILENAME);
+    getAssetCache().prefetch(GAME_FONT_FILENAME, AssetType::FONT);
 }
 
-Game::Game(Player& player, Camera& camera, Level& level) 
-    : player(player), camera(camera), level(level), fpsDisplay(GAME_FONT), timerDisplay(GAME_FONT) {
-    pauseMenu = PauseMenu();
-    fpsDisplay = Text(GAME_FONT);
-    fpsDisplay.setPosition({SCREEN_RESOLUTION.x - 120, 0});
-    timerDisplay = Text(GAME_FONT);
-    timerDisplay.setOutlineColor(Color::Black);
-    timerDisplay.setOutlineThickness(1);
+/**
+ * Load everything that is only needed to draw the game, headless runs skip it
+ * The level, the player and the entities are packed into one texture atlas so the world is drawn without switching textures
+ */
+void Game::loadGraphics() {
+    atlas = make_shared<TextureAtlas>();
+    atlas->add(AtlasRegion::TILESET, level->getTileset());
+    atlas->add(AtlasRegion::BACKGROUND, getAssetCache().load(BACKGROUND_SPRITE_FILENAME));
+    atlas->add(AtlasRegion::PLAYER, getAssetCache().load(PLAYER_SPRITE_FILENAME));
+    atlas->add(AtlasRegion::TUTORIAL_ARROW, getAssetCache().load(TUTORIAL_ARROW_FILENAME));
+    atlas->add(AtlasRegion::SACRED_FRUIT, getAssetCache().load(SACRED_FRUIT_FILENAME));
+    atlas->pack();
+
+    player.loadGraphics(*atlas);
+    level->loadGraphics(*atlas);
+    world.loadGraphics(*atlas);
+    hud.loadGraphics(getGameFont());
+}
+
+/**
+ * Advance the simulation for the time the last frame took, then draw
+ */
+void Game::run(float frameTime, RenderWindow& window, Input& input) {
+    const float tickTime = 1.0f / TICK_RATE;
+    runTicks(frameTime, input);
+    draw(window, accumulator / tickTime, frameTime);
 }
 
-void Game::run(float deltaTime, Clock& globalClock, RenderWindow& window, Input& input) {
+/**
+ * Advance the simulation by fixed ticks for the time the last frame took, without drawing
+ * Input is consumed by the first tick so a key press is seen exactly once, even when no tick runs this frame
+ */
+void Game::runTicks(float frameTime, Input& input) {
+    const float tickTime = 1.0f / TICK_RATE;
+    accumulator += frameTime;
+
+    ticksLastFrame = 0;
+    while (accumulator >= tickTime && ticksLastFrame < MAX_TICKS_PER_FRAME) {
+        previousPlayerPosition = player.getSprite().getPosition();
+        previousCameraCenter = camera.getView().getCenter();
+
+        if (replay != nullptr) {
+            replay->apply(tickCount, input);
+        }
+        update(input);
+        input.clear();
+
+        accumulator -= tickTime;
+        ticksLastFrame++;
+    }
+    // Avoid the spiral of death, the time the simulation could not catch up with is dropped
+    if (ticksLastFrame == MAX_TICKS_PER_FRAME) {
+        accumulator = min(accumulator, tickTime);
+    }
+}
+
+/**
+ * One simulation step of 1 / TICK_RATE seconds, does not need a window
+ */
+void Game::update(const Input& input) {
+    const float deltaTime = 1.0f / TICK_RATE;
+    globalClock.tick();
+    tickCount++;
+
     if (input.isKeyTriggered(Keyboard::Scancode::Escape)) {
         pause = !pause;
         pauseMenu.resetCursor();
     }
 
-    if (!pause && !gameFinished) {
-        player.update(deltaTime, globalClock, level, input);
-        camera.update(player.getHitbox().getPosition(), level.getSize());
+    // Page level chunks in and out around what the camera shows
+    level->updateStreaming(FloatRect(camera.getView().getCenter() - camera.getView().getSize() / 2.0f, camera.getView().getSize()));
+
+    if (pause) {
+        bool retryRequested = false;
+        pauseMenu.update(pause, quit, retryRequested, input);
+        if (retryRequested) {
+            retry();
+        }
+        return;
     }
+    // Go back one tick per tick while the key is held
+    if (input.isKeyHeld(Keyboard::Scancode::Backspace)) {
+        rewind();
+        return;
+    }
+    if (gameFinished) {
+        return;
+    }
+
+    // The tiles around the player are loaded before moving it so the simulation is deterministic,
+    // usually the loader already has them and this loads nothing
+    FloatRect playerArea = player.getHitbox().getGlobalBounds();
+    level->requireTiles(FloatRect(playerArea.position - Vector2f(TILE_SIZE) * 4.0f, playerArea.size + Vector2f(TILE_SIZE) * 8.0f));
+
+    player.update(deltaTime, globalClock, *level, input);
+    camera.update(player.getHitbox().getPosition(), level->getSize());
+
+    updateActiveEntities(deltaTime);
+    updatePlayerOverlaps(gameFinished);
+    if (gameFinished) {
+        globalClock.stop();
+    }
+
+    GameSnapshot snapshot;
+    captureSnapshot(snapshot);
+    rewindBuffer.push(snapshot);
+}
+
+/**
+ * Draw the game, the player and the camera are drawn between their last two ticks (alpha from 0 to 1)
+ */
+void Game::draw(RenderWindow& window, float alpha, float frameTime) {
+    Vector2f playerPosition = player.getSprite().getPosition();
+    Vector2f playerOffset = (previousPlayerPosition - playerPosition) * (1.0f - alpha);
+    RenderStates playerStates = RenderStates(Transform().translate(playerOffset));
+
+    View view = camera.getView();
+    view.setCenter(previousCameraCenter + (view.getCenter() - previousCameraCenter) * alpha);
 
     // Draw game
     
-    window.setView(camera.getView());
-    window.draw(level);
-    window.draw(player.getSprite());
-    window.draw(player.getHitbox());
+    window.setView(view);
+    window.draw(*level);
+    spriteBatch.add(player.getSprite(), LAYER_PLAYER, playerStates.transform);
+    if (!gameFinished) {
+        world.draw(spriteBatch, activeEntities);
+    }
+    spriteBatch.draw(window);
 
     if (!gameFinished) {
-        for (int i = 0; i < level.entities.size(); i++) {
-            window.draw(level.entities[i]->getSprite());
-            level.entities[i]->update(deltaTime, player, window, gameFinished);
-        }
-        timerDisplay.setString(precision(globalClock.getElapsedTime().asSeconds(), 3));
-    } else {
-        globalClock.stop();
-        timerDisplay.setString("GG! " + precision(globalClock.getElapsedTime().asSeconds(), 3));
-        timerDisplay.setCharacterSize(50);
-        timerDisplay.setOrigin(timerDisplay.getLocalBounds().getCenter());
-        timerDisplay.setPosition({SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2});
+        world.drawTexts(window, activeEntities);
     }
 
     if (DEBUG) {
-        std::vector<std::vector<Tile>> tiles = level.getTiles();
-        Vector2u levelSize = level.getSize();
-        for (int i = 0; i < levelSize.x; i++) {
-            for (int j = 0; j < levelSize.y; j++) {
-                window.draw(tiles[i][j].getHitbox());
+        window.draw(player.getHitbox(), playerStates);
+
+        // Only go through the tiles visible by the camera
+        const TileMap& tiles = level->getTiles();
+        Vector2f viewPosition = view.getCenter() - view.getSize() / 2.0f;
+        int startX = viewPosition.x / TILE_SIZE.x;
+        int startY = viewPosition.y / TILE_SIZE.y;
+        int endX = startX + SCREEN_RESOLUTION.x / TILE_SIZE.x + 1;
+        int endY = startY + SCREEN_RESOLUTION.y / TILE_SIZE.y + 1;
+
+        RectangleShape tileHitbox;
+        tileHitbox.setFillColor(Color::Transparent);
+        tileHitbox.setOutlineThickness(-1);
+        tileHitbox.setOutlineColor(Color::Red);
+
+        for (int x = startX; x <= endX; x++) {
+            for (int y = startY; y <= endY; y++) {
+                if (!tiles.contains(x, y) || !(tiles.getFlags(x, y) & (TILE_SOLID | TILE_DANGEROUS))) {
+                    continue;
+                }
+                FloatRect bounds = tiles.getHitbox(x, y);
+                tileHitbox.setPosition(bounds.position);
+                tileHitbox.setSize(bounds.size);
+                window.draw(tileHitbox);
             }
         }
     }
 
     // Draw UI
 
+    updateHud(frameTime, DEBUG || Keyboard::isKeyPressed(Keyboard::Key::F1));
     window.setView(window.getDefaultView());
-    window.draw(timerDisplay);
+    hud.draw(window);
+}
 
-    if (DEBUG || Keyboard::isKeyPressed(Keyboard::Key::F1)) {
-        fpsDisplay.setString(to_string(1.0f / deltaTime));
-        window.draw(fpsDisplay);
+/**
+ * Write the timer, the statistics and the pause menu in the HUD
+ * Numbers have fixed width fields so only the digits that changed are written again, nothing is allocated
+ */
+void Game::updateHud(float frameTime, bool showStats) {
+    HudString timer;
+    if (gameFinished) {
+        timer.append("GG! ");
     }
-    
-    if (pause) {
-        pauseMenu.update(deltaTime, pause, player, Vector2f(level.getSpawnPosition()), input, window);
+    timer.append(globalClock.getElapsedSeconds(), 3, 2);
+    hud.setText(gameFinished ? finishedText : timerText, timer.view());
+    hud.setVisible(timerText, !gameFinished);
+    hud.setVisible(finishedText, gameFinished);
+
+    hud.setVisible(statsText, showStats);
+    if (showStats) {
+        HudString stats;
+        stats.append((uint64_t) (frameTime > 0.0f ? 1.0f / frameTime : 0.0f), 5).append(" fps\n");
+        stats.append((uint64_t) ticksLastFrame, 5).append(" ticks\n");
+        stats.append((uint64_t) level->getDrawnChunks(), 5).append(" drawn");
+        if (level->isStreamed()) {
+            // Resident level memory against the memory the whole level would take
+            stats.append("\n").append((uint64_t) level->getTiles().getResidentChunks().size(), 5).append(" chunks ")
+                .append((uint64_t) level->getPeakResidentBytes() / 1024, 5).append("/")
+                .append((uint64_t) level->getFullLevelBytes() / 1024, 5).append("KB ")
+                .append((uint64_t) level->getSynchronousLoads(), 4).append(" sync");
+        }
+        stats.append("\n").append((uint64_t) activeEntities.size(), 5).append(" active ")
+            .append((uint64_t) (world.size() - activeEntities.size()), 5).append(" asleep");
+        stats.append("\n").append((uint64_t) spriteBatch.getDrawnSprites(), 5).append(" sprites ")
+            .append((uint64_t) spriteBatch.getDrawCalls(), 3).append(" draws");
+        stats.append("\n").append((uint64_t) rewindBuffer.getSnapshotCount() / TICK_RATE, 5).append("s rewind ")
+            .append((uint64_t) rewindBuffer.getUsedBytes() / 1024, 4).append("/")
+            .append((uint64_t) rewindBuffer.getMemoryBudget() / 1024, 4).append("KB");
+        hud.setText(statsText, stats.view());
+    }
+
+    pauseMenu.updateHud(hud, pause);
+}
+
+const Hud& Game::getHud() const {
+    return hud;
+}
+
+/**
+ * Update the entities around the view, found with the entity grid so the cost does not depend on the size of the level
+ * The others sleep, an entity coming back in range is caught up with the time it slept in one step
+ */
+void Game::updateActiveEntities(float deltaTime) {
+    entityTicks++;
+    View view = camera.getView();
+    FloatRect region = FloatRect(view.getCenter() - view.getSize() / 2.0f - Vector2f(ENTITY_WAKE_MARGIN, ENTITY_WAKE_MARGIN), 
+        view.getSize() + Vector2f(ENTITY_WAKE_MARGIN, ENTITY_WAKE_MARGIN) * 2.0f);
+
+    activeEntities.clear();
+    entityGrid.query(region, [&](uint32_t entity) {
+        activeEntities.push_back(entity);
+    });
+    for (uint32_t entity : activeEntities) {
+        uint64_t sleptTicks = entityTicks - entityAwakeTicks[entity] - 1;
+        if (sleptTicks > 0) {
+            world.wake(entity, sleptTicks * deltaTime);
+        }
+        entityAwakeTicks[entity] = entityTicks;
     }
+    world.animate(activeEntities, deltaTime);
+}
+
+/**
+ * Move the player entity to the hitbox of the player and run the trigger system on the entities it overlaps,
+ * only the entities in the grid cells around the player are tested
+ */
+void Game::updatePlayerOverlaps(bool& finished) {
+    world.setPosition(playerEntity, player.getHitbox().getPosition());
+    FloatRect playerBounds = world.getBounds(playerEntity);
+    entityGrid.move(playerEntity, playerBounds);
+
+    swap(previousEntitiesTouchingPlayer, entitiesTouchingPlayer);
+    entitiesTouchingPlayer.clear();
+    entityGrid.query(playerBounds, [&](uint32_t entity) {
+        if (entity != playerEntity) {
+            entitiesTouchingPlayer.push_back(entity);
+        }
+    });
+    world.updateTriggers(previousEntitiesTouchingPlayer, entitiesTouchingPlayer, finished);
+}
+
+/**
+ * Copy the state of the simulation, a few microseconds
+ */
+void Game::captureSnapshot(GameSnapshot& snapshot) const {
+    // Zeroed so the padding bytes are the same in every snapshot
+    memset((void*) &snapshot, 0, sizeof(GameSnapshot));
+    player.saveState(snapshot.player);
+    snapshot.clockTicks = globalClock.getTicks();
+    snapshot.clockRunning = globalClock.isRunning();
+    snapshot.gameFinished = gameFinished;
+}
+
+/**
+ * Put the simulation back in a captured state, the tick count keeps going so recordings stay in sync
+ */
+void Game::restoreSnapshot(const GameSnapshot& snapshot) {
+    player.loadState(snapshot.player);
+    globalClock.restore(snapshot.clockTicks, snapshot.clockRunning);
+    gameFinished = snapshot.gameFinished;
+    camera.update(player.getHitbox().getPosition(), level->getSize());
+
+    // Only updates what the entities show, whether the level was finished comes from the snapshot
+    bool finished = false;
+    world.resetCollectibles();
+    updatePlayerOverlaps(finished);
+}
+
+/**
+ * Go back to the previous tick, returns false when the history is empty
+ */
+bool Game::rewind() {
+    GameSnapshot snapshot;
+    if (!rewindBuffer.rewind(snapshot)) {
+        return false;
+    }
+    restoreSnapshot(snapshot);
+    return true;
+}
+
+/**
+ * Start the level again right away
+ */
+void Game::retry() {
+    restoreSnapshot(startSnapshot);
+    rewindBuffer.clear();
+    rewindBuffer.push(startSnapshot);
+}
+
+const RewindBuffer& Game::getRewindBuffer() const {
+    return rewindBuffer;
+}
+
+/**
+ * Play a recorded run, its key events are sent to the input before the ticks they were recorded for
+ */
+void Game::setReplay(InputReplay* replay) {
+    this->replay = replay;
+}
+
+uint64_t Game::getTickCount() const {
+    return tickCount;
+}
+
+RunResult Game::getResult() {
+    return {player.getHitbox().getPosition(), globalClock.getTicks(), gameFinished};
+}
+
+bool Game::isFinished() const {
+    return gameFinished;
+}
+
+bool Game::isQuitRequested() const {
+    return quit;
+}
+
+const GameClock& Game::getClock() const {
+    return globalClock;
 }
 
 Player& Game::getPlayer() {
     return player;
 }
 
+Camera& Game::getCamera() {
+    return camera;
+}
+
 void Game::setPlayer(Player& player) {
     this->player = player;
 }
 
+/**
+ * Play a level, the level itself is only read by the simulation unless it is streamed
+ */
 void Game::setLevel(Level& level) {
-    this->level = level;
+    this->level = &level;
+    world.clear();
+    entitiesTouchingPlayer.clear();
+    previousEntitiesTouchingPlayer.clear();
+    activeEntities.clear();
+    entityAwakeTicks.clear();
+    entityTicks = 0;
+    entityGrid = EntityGrid(Vector2f(level.getSize().x * TILE_SIZE.x, level.getSize().y * TILE_SIZE.y));
+
+    playerEntity = world.create(COMPONENT_AABB, player.getHitbox().getPosition());
+    world.setBox(playerEntity, {0, 0}, HITBOX_SIZE);
+    entityGrid.insert(world.getBounds(playerEntity));
+    entityAwakeTicks.push_back(entityTicks);
+    for (const EntitySpawn& spawn : level.entities) {
+        addEntity(spawn);
+    }
+
+    captureSnapshot(startSnapshot);
+    rewindBuffer.clear();
+    rewindBuffer.push(startSnapshot);
+}
+
+/**
+ * Add an entity to this game only, the level is left untouched
+ */
+Entity Game::addEntity(const EntitySpawn& spawn) {
+    Entity entity = world.spawn(spawn);
+    entityGrid.insert(world.getBounds(entity));
+    entityAwakeTicks.push_back(entityTicks);
+    return entity;
+}
+
+const EntityWorld& Game::getEntityWorld() const {
+    return world;
+}
+
+const EntityGrid& Game::getEntityGrid() const {
+    return entityGrid;
+}
+
+size_t Game::getActiveEntityCount() const {
+    return activeEntities.size();
 }
\ No newline at end of file
@@ -6,29 +6,96 @@
 #include "level.h"
 #include "pauseMenu.h"
 #include "input.h"
+#include "gameClock.h"
+#include "inputRecording.h"
+#include "snapshot.h"
+#include "rewindBuffer.h"
+#include "entityGrid.h"
+#include "spriteBatch.h"
+#include "hud.h"
 
 #define LEVEL_FILENAME "assets/levels/test2.lvl"
 #define LEVEL_TILESET "assets/tiles/tiles.png"
 
+#define TICK_RATE 120 // Simulation steps per second, independent from the display rate
+#define MAX_TICKS_PER_FRAME 8 // Slow frames drop simulation time past this instead of falling further behind
+
+#define ENTITY_WAKE_MARGIN 128.0f // Entities closer than this to the view are updated, the others sleep
+
+#define REWIND_BUFFER_BYTES (64 * 1024) // Memory for the rewind history, a tick takes around 50 bytes
+#define REWIND_MAX_SECONDS 10
+
+#define HUD_TIMER_CAPACITY 12
+#define HUD_STATS_CAPACITY 176
+
 class Game {
     private:
         Player player;
         Camera camera;
-        Level level;
+        Level* level; // Levels own their chunks and loader thread, they are not copied
+        EntityWorld world; // The player and the entities of the level, spawned for each game so games can share a level
+        Entity playerEntity; // Follows the hitbox of the player, triggers and collectibles are tested against it
+        EntityGrid entityGrid; // Bounds of the entities, indexed like the world
+        vector<uint32_t> entitiesTouchingPlayer;
+        vector<uint32_t> previousEntitiesTouchingPlayer;
+        vector<uint32_t> activeEntities; // Entities around the view, the only ones updated and drawn
+        vector<uint64_t> entityAwakeTicks; // Last entity tick each entity was updated at
+        uint64_t entityTicks = 0;
 
+        shared_ptr<TextureAtlas> atlas; // Every image of the world, shared by the copies of the game
+        SpriteBatch spriteBatch; // The player and the entities, drawn in one call when they all come from the atlas
+        Hud hud; // Timer, statistics and pause menu, drawn in one call
+        HudElement timerText;
+        HudElement finishedText;
+        HudElement statsText;
         PauseMenu pauseMenu;
-        Text fpsDisplay;
-        Text timerDisplay;
 
+        GameClock globalClock; // Used to know in how much time the player completed the level
+        uint64_t tickCount = 0; // Ticks simulated since the game started, never reset
+        InputReplay* replay = nullptr;
+        RewindBuffer rewindBuffer; // One snapshot per tick, held Backspace goes back through them
+        GameSnapshot startSnapshot; // Restored by the retry button of the pause menu
         bool pause = false;  
         bool gameFinished = false;    
+        bool quit = false;
+
+        float accumulator = 0.0f; // Simulation time not consumed by a tick yet
+        int ticksLastFrame = 0;
+        Vector2f previousPlayerPosition;
+        Vector2f previousCameraCenter;
+
+        void draw(RenderWindow& window, float alpha, float frameTime);
+        void updatePlayerOverlaps(bool& finished);
+        void updateActiveEntities(float deltaTime);
 
     public:
         Game(Player& player, Camera& camera, Level& level);
-        void run(float deltaTime, Clock& globalClock, RenderWindow& window, Input& input);
+        static void prefetchAssets(string tilesetFilename);
+        void loadGraphics();
+        void run(float frameTime, RenderWindow& window, Input& input);
+        void runTicks(float frameTime, Input& input);
+        void updateHud(float frameTime, bool showStats);
+        const Hud& getHud() const;
+        void update(const Input& input);
+        void captureSnapshot(GameSnapshot& snapshot) const;
+        void restoreSnapshot(const GameSnapshot& snapshot);
+        bool rewind();
+        void retry();
+        const RewindBuffer& getRewindBuffer() const;
+        void setReplay(InputReplay* replay);
+        uint64_t getTickCount() const;
+        bool isFinished() const;
+        RunResult getResult();
+        bool isQuitRequested() const;
+        const GameClock& getClock() const;
         Player& getPlayer();
+        Camera& getCamera();
         void setPlayer(Player& player);
         void setLevel(Level& level);
+        Entity addEntity(const EntitySpawn& spawn);
+        const EntityWorld& getEntityWorld() const;
+        const EntityGrid& getEntityGrid() const;
+        size_t getActiveEntityCount() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "gameClock.h"
+
+GameClock::GameClock(int tickRate) : tickRate(tickRate) {}
+
+void GameClock::tick() {
+    if (running) {
+        ticks++;
+    }
+}
+
+void GameClock::restart() {
+    ticks = 0;
+    running = true;
+}
+
+void GameClock::stop() {
+    running = false;
+}
+
+/**
+ * Go back to a previously saved time
+ */
+void GameClock::restore(uint64_t ticks, bool running) {
+    this->ticks = ticks;
+    this->running = running;
+}
+
+bool GameClock::isRunning() const {
+    return running;
+}
+
+uint64_t GameClock::getTicks() const {
+    return ticks;
+}
+
+float GameClock::getElapsedSeconds() const {
+    return (float) ticks / tickRate;
+}
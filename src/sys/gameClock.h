@@ -0,0 +1,27 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <cstdint>
+
+/**
+ * Simulation time counted in ticks, so the level timer does not depend on the real time
+ * (headless runs go much faster than real time)
+ */
+class GameClock {
+    private:
+        uint64_t ticks = 0;
+        int tickRate;
+        bool running = true;
+
+    public:
+        GameClock(int tickRate);
+        void tick();
+        void restart();
+        void stop();
+        void restore(uint64_t ticks, bool running);
+        bool isRunning() const;
+        uint64_t getTicks() const;
+        float getElapsedSeconds() const;
+};
+
+#endif
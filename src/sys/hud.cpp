@@ -0,0 +1,325 @@
+#include "hud.h"
+#include <algorithm>
+#include <cmath>
+
+BitmapFont::BitmapFont() {}
+
+/**
+ * Load the glyphs once, rendering them into the glyph atlas of the font needs a graphics context
+ */
+BitmapFont::BitmapFont(const Font& font) : font(&font) {
+    for (char character = HUD_FIRST_CHARACTER; character <= HUD_LAST_CHARACTER; character++) {
+        glyphs[character - HUD_FIRST_CHARACTER] = font.getGlyph(character, HUD_CHARACTER_SIZE, false);
+        outlineGlyphs[character - HUD_FIRST_CHARACTER] = font.getGlyph(character, HUD_CHARACTER_SIZE, false, HUD_OUTLINE_THICKNESS);
+    }
+    lineSpacing = font.getLineSpacing(HUD_CHARACTER_SIZE);
+}
+
+bool BitmapFont::isLoaded() const {
+    return font != nullptr;
+}
+
+const Texture& BitmapFont::getTexture() const {
+    return font->getTexture(HUD_CHARACTER_SIZE);
+}
+
+/**
+ * Glyph of a printable ASCII character, other characters have no glyph
+ */
+const Glyph& BitmapFont::getGlyph(char character, bool outline) const {
+    static const Glyph empty;
+    if (character < HUD_FIRST_CHARACTER || character > HUD_LAST_CHARACTER) {
+        return empty;
+    }
+    return outline ? outlineGlyphs[character - HUD_FIRST_CHARACTER] : glyphs[character - HUD_FIRST_CHARACTER];
+}
+
+/**
+ * Width of every character, the font is monospaced
+ */
+float BitmapFont::getAdvance() const {
+    return glyphs['0' - HUD_FIRST_CHARACTER].advance;
+}
+
+float BitmapFont::getLineSpacing() const {
+    return lineSpacing;
+}
+
+HudString& HudString::append(string_view text) {
+    size_t count = min(text.size(), HUD_STRING_CAPACITY - length);
+    copy(text.begin(), text.begin() + count, characters + length);
+    length += count;
+    return *this;
+}
+
+/**
+ * Append a number right aligned in a field of width characters, numbers with more digits take more room
+ */
+HudString& HudString::append(uint64_t value, int width, char padding) {
+    char digits[20];
+    int digitCount = 0;
+    do {
+        digits[digitCount++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = digitCount; i < width && length < HUD_STRING_CAPACITY; i++) {
+        characters[length++] = padding;
+    }
+    while (digitCount > 0 && length < HUD_STRING_CAPACITY) {
+        characters[length++] = digits[--digitCount];
+    }
+    return *this;
+}
+
+/**
+ * Append a number truncated to a number of decimals, width is the width of the integer part
+ */
+HudString& HudString::append(float value, int decimals, int width, char padding) {
+    uint64_t power = 1;
+    for (int i = 0; i < decimals; i++) {
+        power *= 10;
+    }
+    uint64_t scaled = (uint64_t) max(0.0, floor((double) value * power));
+    append(scaled / power, width, padding);
+    if (decimals > 0) {
+        append(".");
+        append(scaled % power, decimals, '0');
+    }
+    return *this;
+}
+
+string_view HudString::view() const {
+    return string_view(characters, length);
+}
+
+/**
+ * Use the glyphs of a font from now on, every element is written again with them
+ */
+void Hud::loadGraphics(const Font& font) {
+    this->font = BitmapFont(font);
+    for (Element& element : elements) {
+        if (element.type == ElementType::TEXT) {
+            element.offset = getTextOffset(element, string_view(element.text.data(), element.text.size()));
+            writeText(element);
+        }
+    }
+}
+
+HudElement Hud::addElement(Element element, size_t vertexCount) {
+    element.firstVertex = vertices.size();
+    element.vertexCount = vertexCount;
+    vertices.resize(vertices.size() + vertexCount);
+    elements.push_back(element);
+    if (element.type == ElementType::TEXT) {
+        writeText(elements.back());
+    } else {
+        writeShape(elements.back());
+    }
+    return elements.size() - 1;
+}
+
+/**
+ * Add a text that can later hold up to capacity characters (the length of the text by default), lines are separated by \n
+ */
+HudElement Hud::addText(string_view text, Vector2f position, size_t capacity, float scale, Color color, bool outlined) {
+    Element element;
+    element.type = ElementType::TEXT;
+    element.position = position;
+    element.scale = scale;
+    element.color = color;
+    element.outlined = outlined;
+    element.text = vector<char>(max(capacity, text.size()), ' ');
+    copy(text.begin(), text.end(), element.text.begin());
+    return addElement(element, element.text.size() * 6 * (outlined ? 2 : 1));
+}
+
+HudElement Hud::addRectangle(FloatRect rectangle, Color color) {
+    Element element;
+    element.type = ElementType::RECTANGLE;
+    element.position = rectangle.position;
+    element.size = rectangle.size;
+    element.color = color;
+    return addElement(element, 6);
+}
+
+HudElement Hud::addCircle(Vector2f center, float radius, Color color) {
+    Element element;
+    element.type = ElementType::CIRCLE;
+    element.position = center;
+    element.size = {radius, radius};
+    element.color = color;
+    return addElement(element, HUD_CIRCLE_POINTS * 3);
+}
+
+/**
+ * Write the quads of one character, the outline quad goes in the first half of the element so it is drawn under every character
+ * cell is the column and the line of the character
+ */
+void Hud::writeCharacter(Element& element, size_t slot, Vector2f cell) {
+    char character = element.text[slot];
+    Vector2f pen = element.position + element.offset
+        + Vector2f(cell.x * font.getAdvance(), cell.y * font.getLineSpacing() + HUD_CHARACTER_SIZE) * element.scale;
+
+    for (int outline = 0; outline < (element.outlined ? 2 : 1); outline++) {
+        bool outlineQuad = element.outlined && outline == 0;
+        Vertex* quad = &vertices[element.firstVertex + (outline * element.text.size() + slot) * 6];
+        const Glyph& glyph = font.getGlyph(character, outlineQuad);
+        Color color = !element.visible ? Color::Transparent : outlineQuad ? Color::Black : element.color;
+
+        // Like sf::Text, glyphs are padded by a pixel so smoothing does not cut their edges, blank characters have no quad
+        const float padding = glyph.textureRect.size.x > 0 ? 1.0f : 0.0f;
+        Vector2f topLeft = pen + (glyph.bounds.position - Vector2f(padding, padding)) * element.scale;
+        Vector2f bottomRight = pen + (glyph.bounds.position + glyph.bounds.size + Vector2f(padding, padding)) * element.scale;
+        if (padding == 0.0f) {
+            bottomRight = topLeft;
+        }
+        Vector2f textureTopLeft = Vector2f(glyph.textureRect.position) - Vector2f(padding, padding);
+        Vector2f textureBottomRight = Vector2f(glyph.textureRect.position + glyph.textureRect.size) + Vector2f(padding, padding);
+
+        quad[0] = {topLeft, color, textureTopLeft};
+        quad[1] = {{bottomRight.x, topLeft.y}, color, {textureBottomRight.x, textureTopLeft.y}};
+        quad[2] = {{topLeft.x, bottomRight.y}, color, {textureTopLeft.x, textureBottomRight.y}};
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = {bottomRight, color, textureBottomRight};
+    }
+    rewrittenCharacters++;
+}
+
+void Hud::writeText(Element& element) {
+    Vector2f cell = {0, 0};
+    for (size_t slot = 0; slot < element.text.size(); slot++) {
+        writeCharacter(element, slot, cell);
+        cell = element.text[slot] == '\n' ? Vector2f(0, cell.y + 1) : cell + Vector2f(1, 0);
+    }
+}
+
+/**
+ * Shapes sample the white texel fonts keep at the top left corner of their glyph atlas
+ */
+void Hud::writeShape(Element& element) {
+    Vertex* shape = &vertices[element.firstVertex];
+    Color color = element.visible ? element.color : Color::Transparent;
+    const Vector2f white = {1, 1};
+
+    if (element.type == ElementType::RECTANGLE) {
+        Vector2f end = element.position + element.size;
+        shape[0] = {element.position, color, white};
+        shape[1] = {{end.x, element.position.y}, color, white};
+        shape[2] = {{element.position.x, end.y}, color, white};
+        shape[3] = shape[2];
+        shape[4] = shape[1];
+        shape[5] = {end, color, white};
+        return;
+    }
+
+    for (int point = 0; point < HUD_CIRCLE_POINTS; point++) {
+        float angle = 2 * M_PI * point / HUD_CIRCLE_POINTS;
+        float nextAngle = 2 * M_PI * (point + 1) / HUD_CIRCLE_POINTS;
+        shape[point * 3] = {element.position, color, white};
+        shape[point * 3 + 1] = {element.position + Vector2f(cos(angle), sin(angle)) * element.size.x, color, white};
+        shape[point * 3 + 2] = {element.position + Vector2f(cos(nextAngle), sin(nextAngle)) * element.size.x, color, white};
+    }
+}
+
+/**
+ * Offset putting the origin of a text on its position, the size of the text is its longest line and its number of lines
+ */
+Vector2f Hud::getTextOffset(const Element& element, string_view text) const {
+    if (element.origin == Vector2f(0, 0)) {
+        return {0, 0};
+    }
+    size_t columns = 0, lines = 1, column = 0;
+    for (char character : text) {
+        if (character == '\n') {
+            lines++;
+            column = 0;
+        } else if (character != ' ') {
+            column++;
+            columns = max(columns, column);
+        } else {
+            column++;
+        }
+    }
+    Vector2f size = Vector2f(columns * font.getAdvance(), (lines - 1) * font.getLineSpacing() + HUD_CHARACTER_SIZE) * element.scale;
+    return {-element.origin.x * size.x, -element.origin.y * size.y};
+}
+
+/**
+ * Change the characters of a text, only the characters that differ (or moved because a line break moved) are written again
+ * Text past the capacity of the element is cut
+ */
+void Hud::setText(HudElement element, string_view text) {
+    Element& target = elements[element];
+    text = text.substr(0, target.text.size());
+
+    // Centered and right aligned texts move when their size changes
+    Vector2f offset = getTextOffset(target, text);
+    bool shifted = offset != target.offset;
+    target.offset = offset;
+
+    Vector2f cell = {0, 0};
+    for (size_t slot = 0; slot < target.text.size(); slot++) {
+        char character = slot < text.size() ? text[slot] : ' ';
+        bool changed = character != target.text[slot];
+        if (changed && (character == '\n' || target.text[slot] == '\n')) {
+            shifted = true;
+        }
+        target.text[slot] = character;
+        if (changed || shifted) {
+            writeCharacter(target, slot, cell);
+        }
+        cell = character == '\n' ? Vector2f(0, cell.y + 1) : cell + Vector2f(1, 0);
+    }
+}
+
+/**
+ * Point of a text put at its position, in fractions of its size ({0.5, 0.5} centers it)
+ */
+void Hud::setOrigin(HudElement element, Vector2f origin) {
+    Element& target = elements[element];
+    target.origin = origin;
+    target.offset = getTextOffset(target, string_view(target.text.data(), target.text.size()));
+    writeText(target);
+}
+
+void Hud::setPosition(HudElement element, Vector2f position) {
+    Element& target = elements[element];
+    if (target.position == position) {
+        return;
+    }
+    target.position = position;
+    target.type == ElementType::TEXT ? writeText(target) : writeShape(target);
+}
+
+/**
+ * Hidden elements keep their vertices, made transparent
+ */
+void Hud::setVisible(HudElement element, bool visible) {
+    Element& target = elements[element];
+    if (target.visible == visible) {
+        return;
+    }
+    target.visible = visible;
+    target.type == ElementType::TEXT ? writeText(target) : writeShape(target);
+}
+
+/**
+ * Draw every element in one call, in the order they were added
+ */
+void Hud::draw(RenderTarget& target) const {
+    if (!font.isLoaded() || vertices.empty()) {
+        return;
+    }
+    RenderStates states;
+    states.texture = &font.getTexture();
+    target.draw(vertices.data(), vertices.size(), PrimitiveType::Triangles, states);
+}
+
+/**
+ * Characters written since the HUD was created, setting a text that did not change adds nothing
+ */
+size_t Hud::getRewrittenCharacters() const {
+    return rewrittenCharacters;
+}
\ No newline at end of file
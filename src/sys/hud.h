@@ -0,0 +1,107 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace sf;
+
+#define HUD_CHARACTER_SIZE 30 // Every HUD text uses the glyphs of this size, bigger or smaller texts are scaled
+#define HUD_OUTLINE_THICKNESS 1.0f
+#define HUD_FIRST_CHARACTER ' '
+#define HUD_LAST_CHARACTER '~'
+#define HUD_STRING_CAPACITY 256
+#define HUD_CIRCLE_POINTS 24
+
+typedef uint16_t HudElement; // Index of the element in the HUD
+
+/**
+ * Glyphs of the printable ASCII characters at HUD_CHARACTER_SIZE, filled and outlined
+ * Fonts keep the glyphs of a size in one texture, so every glyph comes from the same glyph atlas
+ * A font that is not loaded has empty glyphs, texts then take no room, which is enough to run without a window
+ */
+class BitmapFont {
+    private:
+        const Font* font = nullptr;
+        Glyph glyphs[HUD_LAST_CHARACTER - HUD_FIRST_CHARACTER + 1];
+        Glyph outlineGlyphs[HUD_LAST_CHARACTER - HUD_FIRST_CHARACTER + 1];
+        float lineSpacing = 0.0f;
+
+    public:
+        BitmapFont();
+        BitmapFont(const Font& font);
+        bool isLoaded() const;
+        const Texture& getTexture() const;
+        const Glyph& getGlyph(char character, bool outline) const;
+        float getAdvance() const;
+        float getLineSpacing() const;
+};
+
+/**
+ * Text built on the stack, numbers are written in fixed width fields so their digits stay in the same place
+ */
+class HudString {
+    private:
+        char characters[HUD_STRING_CAPACITY];
+        size_t length = 0;
+
+    public:
+        HudString& append(string_view text);
+        HudString& append(uint64_t value, int width, char padding = ' ');
+        HudString& append(float value, int decimals, int width, char padding = '0');
+        string_view view() const;
+};
+
+/**
+ * Texts and shapes drawn over the game in one draw call, everything is textured from the glyph atlas of the HUD font
+ * (shapes use its white texel). Each element owns a fixed range of vertices: setting a text only rewrites the characters
+ * that changed and setting the same value again does nothing, so a HUD that does not change costs nothing and never allocates
+ * Texts assume a monospaced font, every character takes the advance of the font
+ */
+class Hud {
+    private:
+        enum class ElementType : uint8_t { TEXT, RECTANGLE, CIRCLE };
+
+        struct Element {
+            ElementType type = ElementType::TEXT;
+            uint32_t firstVertex = 0;
+            uint32_t vertexCount = 0;
+            Vector2f position;
+            Vector2f size; // Rectangles only
+            Vector2f origin; // Texts: point of the text put at the position, 0 0 is the top left corner and 1 1 the bottom right one
+            Vector2f offset; // Texts: offset given by the origin for the current text
+            float scale = 1.0f;
+            Color color;
+            bool outlined = false;
+            bool visible = true;
+            vector<char> text; // As many characters as the text can hold, unused ones are spaces
+        };
+
+        BitmapFont font;
+        vector<Element> elements;
+        vector<Vertex> vertices;
+        size_t rewrittenCharacters = 0;
+
+        HudElement addElement(Element element, size_t vertexCount);
+        void writeCharacter(Element& element, size_t slot, Vector2f cell);
+        void writeText(Element& element);
+        void writeShape(Element& element);
+        Vector2f getTextOffset(const Element& element, string_view text) const;
+
+    public:
+        void loadGraphics(const Font& font);
+        HudElement addText(string_view text, Vector2f position, size_t capacity = 0, float scale = 1.0f, Color color = Color::White, bool outlined = false);
+        HudElement addRectangle(FloatRect rectangle, Color color);
+        HudElement addCircle(Vector2f center, float radius, Color color);
+        void setText(HudElement element, string_view text);
+        void setOrigin(HudElement element, Vector2f origin);
+        void setPosition(HudElement element, Vector2f position);
+        void setVisible(HudElement element, bool visible);
+        void draw(RenderTarget& target) const;
+        size_t getRewrittenCharacters() const;
+};
+
+#endif
\ No newline at end of file
@@ -3,27 +3,37 @@
 Input::Input() {}
 
 void Input::updateKeyPress(Keyboard::Scancode keyPressed) {
-    if (keysPressed.count(keyPressed) == 0) {
-        keysPressed[keyPressed] = true;
+    if (keyPressed == Keyboard::Scancode::Unknown) {
+        return;
     }
+    keysHeld.set((size_t) keyPressed);
+    keysTriggered.set((size_t) keyPressed);
 }
 
 void Input::updateKeyRelease(Keyboard::Scancode keyReleased) {
-    if (keysPressed.count(keyReleased) == 0) {
-        keysPressed[keyReleased] = false;
+    if (keyReleased == Keyboard::Scancode::Unknown) {
+        return;
     }
+    keysHeld.reset((size_t) keyReleased);
+    keysReleased.set((size_t) keyReleased);
 }
 
+/**
+ * Forget the keys triggered and released since the last call, held keys stay held
+ */
 void Input::clear() {
-    for (auto& key : keysPressed) {
-        keysPressed.erase(key.first);
-    }
+    keysTriggered.reset();
+    keysReleased.reset();
+}
+
+bool Input::isKeyTriggered(Keyboard::Scancode keyScancode) const {
+    return keyScancode != Keyboard::Scancode::Unknown && keysTriggered.test((size_t) keyScancode);
 }
 
-bool Input::isKeyTriggered(Keyboard::Scancode keyScancode) {
-    return (keysPressed.count(keyScancode) == 1 && keysPressed[keyScancode] == true);
+bool Input::isKeyReleased(Keyboard::Scancode keyScancode) const {
+    return keyScancode != Keyboard::Scancode::Unknown && keysReleased.test((size_t) keyScancode);
 }
 
-bool Input::isKeyReleased(Keyboard::Scancode keyScancode) {
-    return (keysPressed.count(keyScancode) == 1 && keysPressed[keyScancode] == false);
-}
\ No newline at end of file
+bool Input::isKeyHeld(Keyboard::Scancode keyScancode) const {
+    return keyScancode != Keyboard::Scancode::Unknown && keysHeld.test((size_t) keyScancode);
+}
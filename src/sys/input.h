@@ -2,22 +2,30 @@
 #define INPUT_H
 
 #include <SFML/Graphics.hpp> 
+#include <bitset>
 #include <iostream>
 
 using namespace sf;
 using namespace std;
 
+/**
+ * Keyboard state fed by window events or any other source (scripts, recordings)
+ * Triggered and released keys last until clear() is called, held keys until they are released
+ */
 class Input {
     private:
-        unordered_map<Keyboard::Scancode, bool> keysPressed;
+        bitset<Keyboard::ScancodeCount> keysHeld;
+        bitset<Keyboard::ScancodeCount> keysTriggered;
+        bitset<Keyboard::ScancodeCount> keysReleased;
 
     public:
         Input();
         void updateKeyPress(Keyboard::Scancode keyPressed);
         void updateKeyRelease(Keyboard::Scancode keyReleased);
         void clear();
-        bool isKeyTriggered(Keyboard::Scancode keyScancode);
-        bool isKeyReleased(Keyboard::Scancode keyReleased);
+        bool isKeyTriggered(Keyboard::Scancode keyScancode) const;
+        bool isKeyReleased(Keyboard::Scancode keyScancode) const;
+        bool isKeyHeld(Keyboard::Scancode keyScancode) const;
 };
 
-#endif
\ No newline at end of file
+#endif
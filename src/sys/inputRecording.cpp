@@ -0,0 +1,217 @@
+#include "inputRecording.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * Start a recording, the file is written as the run goes so a crash still leaves the inputs that led to it
+ */
+InputRecorder::InputRecorder(string filename, string levelFilename, int tickRate) : file(filename, ios::binary) {
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open " + filename);
+    }
+    uint32_t magic = INPUT_RECORDING_MAGIC;
+    uint16_t version = INPUT_RECORDING_VERSION;
+    uint16_t rate = tickRate;
+    uint16_t nameLength = levelFilename.size();
+    writeBytes(&magic, sizeof(magic));
+    writeBytes(&version, sizeof(version));
+    writeBytes(&rate, sizeof(rate));
+    writeBytes(&nameLength, sizeof(nameLength));
+    writeBytes(levelFilename.data(), nameLength);
+}
+
+InputRecorder::~InputRecorder() {
+    file.flush();
+}
+
+void InputRecorder::writeBytes(const void* data, size_t size) {
+    file.write((const char*) data, size);
+    bytesWritten += size;
+}
+
+/**
+ * Write the tick delta and the kind of a record as a varint, 7 bits per byte
+ * Most records are less than 32 ticks apart and take a single byte
+ */
+void InputRecorder::writeRecord(uint64_t tick, InputRecordKind kind) {
+    uint64_t value = (tick - lastTick) << 2 | (uint64_t) kind;
+    lastTick = tick;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        writeBytes(&byte, 1);
+    } while (value != 0);
+}
+
+void InputRecorder::recordKeyPress(uint64_t tick, Keyboard::Scancode key) {
+    if (finished || key == Keyboard::Scancode::Unknown) {
+        return;
+    }
+    uint8_t scancode = (uint8_t) key;
+    writeRecord(tick, InputRecordKind::PRESS);
+    writeBytes(&scancode, 1);
+}
+
+void InputRecorder::recordKeyRelease(uint64_t tick, Keyboard::Scancode key) {
+    if (finished || key == Keyboard::Scancode::Unknown) {
+        return;
+    }
+    uint8_t scancode = (uint8_t) key;
+    writeRecord(tick, InputRecordKind::RELEASE);
+    writeBytes(&scancode, 1);
+}
+
+/**
+ * End the recording with the number of ticks simulated and how the run ended, so a replay can check it
+ */
+void InputRecorder::finish(uint64_t tick, const RunResult& result) {
+    if (finished) {
+        return;
+    }
+    uint8_t levelFinished = result.levelFinished;
+    writeRecord(tick, InputRecordKind::END);
+    writeBytes(&result.playerPosition.x, sizeof(float));
+    writeBytes(&result.playerPosition.y, sizeof(float));
+    writeBytes(&result.levelTicks, sizeof(uint64_t));
+    writeBytes(&levelFinished, 1);
+    file.flush();
+    finished = true;
+}
+
+size_t InputRecorder::getBytesWritten() const {
+    return bytesWritten;
+}
+
+InputReplay::InputReplay(string filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open " + filename);
+    }
+    data = vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+    uint32_t magic;
+    uint16_t version, rate, nameLength;
+    readBytes(&magic, sizeof(magic));
+    readBytes(&version, sizeof(version));
+    if (magic != INPUT_RECORDING_MAGIC || version != INPUT_RECORDING_VERSION) {
+        throw runtime_error("Not a supported input recording");
+    }
+    readBytes(&rate, sizeof(rate));
+    readBytes(&nameLength, sizeof(nameLength));
+    levelFilename = string(nameLength, ' ');
+    readBytes(levelFilename.data(), nameLength);
+    tickRate = rate;
+
+    // Go through the records once, so a corrupt recording fails here and its length is known before it is played
+    readRecord();
+    size_t firstPosition = position;
+    uint64_t firstTick = nextTick;
+    InputRecordKind firstKind = nextKind;
+    uint8_t firstKey = nextKey;
+    while (nextKind != InputRecordKind::END) {
+        readRecord();
+    }
+    length = nextTick;
+    position = firstPosition;
+    nextTick = firstTick;
+    nextKind = firstKind;
+    nextKey = firstKey;
+}
+
+void InputReplay::readBytes(void* destination, size_t size) {
+    if (position + size > data.size()) {
+        throw runtime_error("Input recording is truncated");
+    }
+    memcpy(destination, data.data() + position, size);
+    position += size;
+}
+
+/**
+ * Decode the next record, a recording cut short (e.g. by a crash) ends after its last complete record
+ */
+void InputReplay::readRecord() {
+    size_t start = position;
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t byte = 0x80;
+    while (byte & 0x80) {
+        if (position >= data.size() || shift > 63) {
+            position = start;
+            nextKind = InputRecordKind::END;
+            return;
+        }
+        byte = data[position++];
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        shift += 7;
+    }
+
+    nextTick += value >> 2;
+    nextKind = (InputRecordKind) (value & 3);
+    if (nextKind > InputRecordKind::END) {
+        throw runtime_error("Input recording has an unknown record");
+    }
+    if (nextKind == InputRecordKind::END) {
+        uint8_t levelFinished;
+        readBytes(&result.playerPosition.x, sizeof(float));
+        readBytes(&result.playerPosition.y, sizeof(float));
+        readBytes(&result.levelTicks, sizeof(uint64_t));
+        readBytes(&levelFinished, 1);
+        result.levelFinished = levelFinished;
+        complete = true;
+    } else if (position < data.size()) {
+        nextKey = data[position++];
+        if (nextKey >= Keyboard::ScancodeCount) {
+            throw runtime_error("Input recording has an unknown key");
+        }
+    } else {
+        nextKind = InputRecordKind::END;
+    }
+}
+
+/**
+ * Send the key events recorded for a tick to the input, ticks must be applied in order
+ */
+void InputReplay::apply(uint64_t tick, Input& input) {
+    while (nextKind != InputRecordKind::END && nextTick == tick) {
+        if (nextKind == InputRecordKind::PRESS) {
+            input.updateKeyPress((Keyboard::Scancode) nextKey);
+        } else {
+            input.updateKeyRelease((Keyboard::Scancode) nextKey);
+        }
+        readRecord();
+    }
+}
+
+bool InputReplay::isFinished(uint64_t tick) const {
+    return nextKind == InputRecordKind::END && tick >= nextTick;
+}
+
+/**
+ * Tick of the last record, the end of the run for a complete recording
+ */
+uint64_t InputReplay::getLength() const {
+    return length;
+}
+
+string InputReplay::getLevelFilename() const {
+    return levelFilename;
+}
+
+int InputReplay::getTickRate() const {
+    return tickRate;
+}
+
+/**
+ * False when the recording was cut short, it then has no result to check against
+ */
+bool InputReplay::isComplete() const {
+    return complete;
+}
+
+const RunResult& InputReplay::getResult() const {
+    return result;
+}
@@ -0,0 +1,88 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "input.h"
+
+#define INPUT_RECORDING_MAGIC 0x52504C59 // "RPLY"
+#define INPUT_RECORDING_VERSION 3
+
+using namespace std;
+using namespace sf;
+
+/**
+ * Input recording format
+ * Header: magic, version, tick rate, length of the level filename and the level filename
+ * Then one record per key event: varint (ticks since the previous record << 2 | kind) followed by
+ * the scancode for key presses and releases, or the RunResult for the end record
+ * Events of tick N are the ones applied to the Input right before the Nth simulation step
+ */
+enum class InputRecordKind : uint8_t { PRESS = 0, RELEASE = 1, END = 2 };
+
+/**
+ * How a run ended, stored at the end of a recording so a replay can be checked against it
+ */
+struct RunResult {
+    Vector2f playerPosition;
+    uint64_t levelTicks = 0; // Time shown by the level timer, in ticks
+    bool levelFinished = false;
+};
+
+/**
+ * Streams the key events of a run to a file as they happen
+ */
+class InputRecorder {
+    private:
+        ofstream file;
+        uint64_t lastTick = 0;
+        size_t bytesWritten = 0;
+        bool finished = false;
+
+        void writeBytes(const void* data, size_t size);
+        void writeRecord(uint64_t tick, InputRecordKind kind);
+
+    public:
+        InputRecorder(string filename, string levelFilename, int tickRate);
+        ~InputRecorder();
+        void recordKeyPress(uint64_t tick, Keyboard::Scancode key);
+        void recordKeyRelease(uint64_t tick, Keyboard::Scancode key);
+        void finish(uint64_t tick, const RunResult& result);
+        size_t getBytesWritten() const;
+};
+
+/**
+ * Feeds a recorded run back into an Input one tick at a time
+ */
+class InputReplay {
+    private:
+        vector<uint8_t> data;
+        size_t position = 0;
+        string levelFilename;
+        int tickRate = 0;
+
+        uint64_t nextTick = 0;
+        InputRecordKind nextKind = InputRecordKind::END;
+        uint8_t nextKey = 0;
+        uint64_t length = 0;
+        bool complete = false;
+        RunResult result;
+
+        void readBytes(void* destination, size_t size);
+        void readRecord();
+
+    public:
+        InputReplay(string filename);
+        void apply(uint64_t tick, Input& input);
+        bool isFinished(uint64_t tick) const;
+        uint64_t getLength() const;
+        string getLevelFilename() const;
+        int getTickRate() const;
+        bool isComplete() const;
+        const RunResult& getResult() const;
+};
+
+#endif
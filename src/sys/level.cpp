@@ -1,155 +1,275 @@
 #include <SFML/Graphics.hpp>
+#include <cmath>
 #include <fstream>
 #include "level.h"
+#include "levelFile.h"
+#include "levelQuery.h"
 
 Level::Level() {}
 
 /**
  * Class constructor
- * Load a .lvl file and a tileset and build the level object from it
+ * Load a .lvl or compiled .lvlb file and a tileset and build the level object from it
+ * Compiled levels are streamed chunk by chunk around the camera, text levels are fully loaded
+ * Nothing is sent to the GPU until loadGraphics() is called, so levels can be simulated without a window
  */
 Level::Level(string levelFilename, string tilesetFilename) {
-    if (!tileset.loadFromFile(tilesetFilename)) {
-        throw runtime_error("Failed to load tileset");
-    }
-
-    ifstream file(levelFilename);
-    if (!file.is_open()) {
-        throw runtime_error("Failed to open level file");
-    }
-
-    string line;
-
-    unsigned int x = 0; 
-    unsigned int y = -1;
-
-    while (getline(file, line)) {
-        istringstream iss(line);
-        string stringValue;
-        MapEntityType met = MapEntityType::_NULL;
-        Vector2f entitySpawnPosition;
-        x = 0;
-        while (iss >> stringValue) {
-            if (y == -1) { 
-                int value = stoi(stringValue);
-                // Read level size from the first line of the file
-                if (x == 0) {
-                    size.x = value;
-                } else if (x == 1) {
-                    size.y = value;
-
-                    tiles = vector<vector<Tile>>(size.x, vector<Tile>(size.y, Tile()));
-                    entities = {};
-
-                    // Building 2 triangles per tile
-                    mainLayerVertices.setPrimitiveType(PrimitiveType::Triangles);
-                    mainLayerVertices.resize(size.x * size.y * 6);
-
-                    backgroundLayerVertices.setPrimitiveType(PrimitiveType::Triangles);
-                    backgroundLayerVertices.resize(size.x * size.y * 6);
-                // Read spawn position
-                } else if (x == 2) {
-                    spawnPosition.x = value;
-                } else if (x == 3) {
-                    spawnPosition.y = value;
-                }
-            } else if (y < size.y) {
-                int value = stoi(stringValue);
-                // 25 tiles of dimensions 16*16 per row 
-                tiles[x][y] = Tile(x, y, value);
-
-                Vector2u textureCoordinates = {(value % 25) * TILE_SIZE.x, (value / 25) * TILE_SIZE.y};
-
-                // get a pointer to the triangles' mainLayerVertices of the current tile
-                Vertex* triangles = &mainLayerVertices[(x + y * size.x) * 6];
-
-                triangles[0].position = Vector2f(x * TILE_SIZE.x, y * TILE_SIZE.y);
-                triangles[1].position = Vector2f((x + 1) * TILE_SIZE.x, y * TILE_SIZE.y);
-                triangles[2].position = Vector2f(x * TILE_SIZE.x, (y + 1) * TILE_SIZE.y);
-                triangles[3].position = Vector2f(x * TILE_SIZE.x, (y + 1) * TILE_SIZE.y);
-                triangles[4].position = Vector2f((x + 1) * TILE_SIZE.x, y * TILE_SIZE.y);
-                triangles[5].position = Vector2f((x + 1) * TILE_SIZE.x, (y + 1) * TILE_SIZE.y);
-
-                triangles[0].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y);
-                triangles[1].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y);
-                triangles[2].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y + TILE_SIZE.y);
-                triangles[3].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y + TILE_SIZE.y);
-                triangles[4].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y);
-                triangles[5].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y + TILE_SIZE.y);
-            } else if (y < size.y * 2) { // Background layer
-                int value = stoi(stringValue);
-                int backgroundX = x;
-                int backgroundY = y - size.y;
-
-                Vector2u textureCoordinates = {(value % 25) * TILE_SIZE.x, (value / 25) * TILE_SIZE.y};
-
-                // get a pointer to the triangles' backgroundLayerVertices of the current tile
-                Vertex* triangles = &backgroundLayerVertices[(backgroundX + backgroundY * size.x) * 6];
-
-                triangles[0].position = Vector2f(backgroundX * TILE_SIZE.x, backgroundY * TILE_SIZE.y);
-                triangles[1].position = Vector2f((backgroundX + 1) * TILE_SIZE.x, backgroundY * TILE_SIZE.y);
-                triangles[2].position = Vector2f(backgroundX * TILE_SIZE.x, (backgroundY + 1) * TILE_SIZE.y);
-                triangles[3].position = Vector2f(backgroundX * TILE_SIZE.x, (backgroundY + 1) * TILE_SIZE.y);
-                triangles[4].position = Vector2f((backgroundX + 1) * TILE_SIZE.x, backgroundY * TILE_SIZE.y);
-                triangles[5].position = Vector2f((backgroundX + 1) * TILE_SIZE.x, (backgroundY + 1) * TILE_SIZE.y);
-
-                triangles[0].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y);
-                triangles[1].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y);
-                triangles[2].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y + TILE_SIZE.y);
-                triangles[3].texCoords = Vector2f(textureCoordinates.x, textureCoordinates.y + TILE_SIZE.y);
-                triangles[4].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y);
-                triangles[5].texCoords = Vector2f(textureCoordinates.x + TILE_SIZE.x, textureCoordinates.y + TILE_SIZE.y);
-            } else { // Entities
-                if (x == 0) {
-                    if (!stringValue.compare("TA")) {
-                        met = MapEntityType::TUTORIAL_ARROW;
-                    } else if (!stringValue.compare("SF")) {
-                        met = MapEntityType::SACRED_FRUIT;
-                    }
-                } else if (x == 1) {
-                    int value = stoi(stringValue);
-                    entitySpawnPosition.x = value;
-                } else if (x == 2) {
-                    int value = stoi(stringValue);
-                    entitySpawnPosition.y = value; 
-                    if (met == MapEntityType::TUTORIAL_ARROW) {
-                        getline(iss, line);
-                        MapEntity* entity = new MapEntity(met, entitySpawnPosition, line);
-                        entities.push_back(entity);
-                    } else {
-                        MapEntity* entity = new MapEntity(met, entitySpawnPosition);
-                        entities.push_back(entity);
-                    }                 
-                }
-            }
-            x++;
+    // The tileset image is needed right away for the meshes and the collision masks, its texture only to draw
+    tileset = getAssetCache().load(tilesetFilename);
+    const Image& tilesetImage = tileset.getImage();
+    meshBuilder = TileMeshBuilder(tilesetImage);
+    tileMasks = TileMaskSet(tilesetImage, TILE_MASK_DIRECTORY);
+
+    chunkPool = make_unique<ObjectPool<TileChunk>>();
+
+    if (isBinaryLevelFile(levelFilename)) {
+        streamer = make_unique<ChunkStreamer>(levelFilename, *chunkPool);
+        const LevelFileView& view = streamer->getView();
+
+        size = {view.header->width, view.header->height};
+        // Enough chunks for the residency budget in one slab, the pool grows if more are resident
+        chunkPool->reserve(min<size_t>((size_t) view.chunkCount.x * view.chunkCount.y, CHUNK_RESIDENCY_BUDGET));
+        spawnPosition = {view.header->spawnX, view.header->spawnY};
+        tiles = TileMap(size);
+
+        // The spawn area is loaded right away and stays in memory for respawns
+        installedChunks.reserve(tiles.getResidentChunks().capacity());
+        streamer->prime(tiles, FloatRect(Vector2f(spawnPosition) - Vector2f(SCREEN_RESOLUTION) / 2.0f, Vector2f(SCREEN_RESOLUTION)), installedChunks);
+        for (int index : installedChunks) {
+            installChunk(index);
+        }
+
+        entities = arena.createArray<EntitySpawn>(view.header->entityCount);
+        for (unsigned int i = 0; i < view.header->entityCount; i++) {
+            const LevelFileEntity& entity = view.entities[i];
+            string_view tutorialText(view.stringPool + entity.textOffset, entity.textLength);
+            entities[i] = createEntity(string_view(entity.tag, 2), Vector2f(entity.x, entity.y), tutorialText);
         }
-        y++;
+    } else {
+        LevelData data = readTextLevel(levelFilename);
+
+        size = data.size;
+        spawnPosition = data.spawnPosition;
+        Vector2u chunkCount = getChunkCount(size);
+        chunkPool->reserve(chunkCount.x * chunkCount.y);
+        tiles = TileMap(size, data.mainLayer.data(), data.backgroundLayer.data(), *chunkPool);
+        for (int index : tiles.getResidentChunks()) {
+            installChunk(index);
+        }
+
+        entities = arena.createArray<EntitySpawn>(data.entities.size());
+        for (size_t i = 0; i < data.entities.size(); i++) {
+            entities[i] = createEntity(data.entities[i].tag, data.entities[i].position, data.entities[i].tutorialText);
+        }
+    }
+}
+
+/**
+ * Start decoding the images of a level on the asset cache threads, before the level itself is loaded
+ */
+void Level::prefetchAssets(string tilesetFilename) {
+    getAssetCache().prefetch(tilesetFilename);
+    getAssetCache().prefetch(BACKGROUND_SPRITE_FILENAME);
+}
+
+/**
+ * Build the meshes of the resident chunks, tiles are sampled from the atlas holding the tileset and the background
+ */
+void Level::loadGraphics(const TextureAtlas& atlas) {
+    this->atlas = &atlas;
+    meshBuilder.setTileOrigins(atlas.getTileOrigins());
+    graphicsLoaded = true;
+    // Every resident chunk is rebuilt, so the totals are counted again from them
+    vertexCount = 0;
+    fullVertexCount = 0;
+    for (int index : tiles.getResidentChunks()) {
+        residentBytes -= getChunkBytes(*tiles.getChunk(index));
+        buildChunkMesh(index);
+        residentBytes += getChunkBytes(*tiles.getChunk(index));
+    }
+    peakResidentBytes = max(peakResidentBytes, residentBytes);
+
+    if (DEBUG) {
+        cout << "Level meshes: " << fullVertexCount << " -> " << vertexCount << " tile vertices for the " 
+            << tiles.getResidentChunks().size() << " resident chunks" << endl;
+    }
+}
+
+/**
+ * Account for a chunk that just became resident, and build its mesh when the level is drawn
+ */
+void Level::installChunk(int index) {
+    if (graphicsLoaded) {
+        buildChunkMesh(index);
+    }
+    residentBytes += getChunkBytes(*tiles.getChunk(index));
+    peakResidentBytes = max(peakResidentBytes, residentBytes);
+}
+
+/**
+ * Build the vertices of a chunk and upload them to static vertex buffers
+ */
+void Level::buildChunkMesh(int index) {
+    TileChunk* chunk = tiles.getChunk(index);
+    Vector2u chunkPosition = {index % tiles.getChunkCount().x * CHUNK_SIZE, index / tiles.getChunkCount().x * CHUNK_SIZE};
+    Vector2u chunkTiles = getChunkTiles(index);
+
+    // Building 2 triangles per visible tile or per run of uniform tiles
+    meshBuilder.build(chunk->mainLayerVertices, chunk->tileTypes, CHUNK_SIZE, chunkPosition, chunkTiles);
+    meshBuilder.build(chunk->backgroundLayerVertices, chunk->backgroundTileTypes, CHUNK_SIZE, chunkPosition, chunkTiles);
+
+    vertexCount += chunk->mainLayerVertices.size() + chunk->backgroundLayerVertices.size();
+    fullVertexCount += chunkTiles.x * chunkTiles.y * 2 * 6;
+
+    if (VertexBuffer::isAvailable()) {
+        uploadVertices(chunk->mainLayerBuffer, chunk->mainLayerVertices);
+        uploadVertices(chunk->backgroundLayerBuffer, chunk->backgroundLayerVertices);
+    }
+}
+
+/**
+ * Upload vertices to the GPU once and free the CPU copy
+ */
+void Level::uploadVertices(VertexBuffer& buffer, vector<Vertex>& vertices) {
+    if (!vertices.empty() && buffer.create(vertices.size()) && buffer.update(vertices.data())) {
+        vertices = vector<Vertex>();
+    }
+}
+
+/**
+ * Tiles of a chunk inside the level, chunks on the right and bottom edges can go past it
+ */
+Vector2u Level::getChunkTiles(int index) const {
+    Vector2u chunkPosition = {index % tiles.getChunkCount().x * CHUNK_SIZE, index / tiles.getChunkCount().x * CHUNK_SIZE};
+    return {min<unsigned int>(CHUNK_SIZE, size.x - chunkPosition.x), min<unsigned int>(CHUNK_SIZE, size.y - chunkPosition.y)};
+}
+
+/**
+ * Vertices of the meshes of a chunk, on the GPU or still on the CPU
+ */
+size_t Level::getChunkVertexCount(const TileChunk& chunk) const {
+    return chunk.mainLayerBuffer.getVertexCount() + chunk.backgroundLayerBuffer.getVertexCount()
+        + chunk.mainLayerVertices.size() + chunk.backgroundLayerVertices.size();
+}
+
+size_t Level::getChunkBytes(const TileChunk& chunk) const {
+    return sizeof(TileChunk) + getChunkVertexCount(chunk) * sizeof(Vertex);
+}
+
+/**
+ * Page chunks in and out around a region in pixels, usually the camera view
+ * Does nothing for fully loaded levels
+ */
+void Level::updateStreaming(FloatRect region) {
+    if (streamer == nullptr) {
+        return;
+    }
+
+    installedChunks.clear();
+    evictedChunks.clear();
+
+    streamer->update(tiles, region, installedChunks, evictedChunks);
+
+    for (int index : installedChunks) {
+        installChunk(index);
+    }
+    for (int index : evictedChunks) {
+        residentBytes -= getChunkBytes(*tiles.getChunk(index));
+        if (graphicsLoaded) {
+            vertexCount -= getChunkVertexCount(*tiles.getChunk(index));
+            fullVertexCount -= getChunkTiles(index).x * getChunkTiles(index).y * 2 * 6;
+        }
+        tiles.releaseChunk(index);
+    }
+}
+
+/**
+ * Make sure the tiles of an area in pixels are loaded, waiting for them if needed
+ * Collision queries in that area then give the same result whatever the loader thread is doing
+ */
+void Level::requireTiles(FloatRect area) {
+    if (streamer == nullptr) {
+        return;
     }
 
-    if (!backgroundTexture.loadFromFile(BACKGROUND_SPRITE_FILENAME)) {
-        throw runtime_error("Failed to load background");
+    installedChunks.clear();
+    streamer->require(tiles, area, installedChunks);
+    for (int index : installedChunks) {
+        installChunk(index);
     }
 }
 
+/**
+ * Load every chunk and stop streaming, the level is then never modified by the simulation 
+ * and can be shared by games running on several threads
+ */
+void Level::loadAllChunks() {
+    requireTiles(FloatRect({0, 0}, {(float) size.x * TILE_SIZE.x, (float) size.y * TILE_SIZE.y}));
+    streamer = nullptr;
+}
+
+void Level::setResidencyBudget(size_t chunks) {
+    if (streamer != nullptr) {
+        streamer->setResidencyBudget(chunks);
+    }
+}
+
+/**
+ * Entity from its tag in the level file, the tutorial text is copied into the level arena
+ */
+EntitySpawn Level::createEntity(string_view tag, Vector2f spawnPosition, string_view tutorialText) {
+    if (tag == "TA") {
+        return {MapEntityType::TUTORIAL_ARROW, spawnPosition, arena.copyString(tutorialText)};
+    } else if (tag == "SF") {
+        return {MapEntityType::SACRED_FRUIT, spawnPosition, ""};
+    }
+    return {MapEntityType::_NULL, spawnPosition, ""};
+}
+
 /**
  * Override draw method from sf::Drawable
  */
 void Level::draw(RenderTarget& target, RenderStates states) const {
+    if (atlas == nullptr) {
+        return;
+    }
+
     // Draw the background first
-    Sprite background = Sprite(backgroundTexture);
-    background.setScale({5, 5});
-    target.draw(background);
+    Sprite backgroundSprite = Sprite(atlas->getTexture(), atlas->getRegion(AtlasRegion::BACKGROUND));
+    backgroundSprite.setScale({5, 5});
+    target.draw(backgroundSprite);
 
     // apply the transform
     states.transform *= getTransform();
 
-    // apply the tileset texture
-    states.texture = &tileset;
+    // apply the atlas texture, the tiles of the meshes are already in atlas coordinates
+    states.texture = &atlas->getTexture();
 
-    // draw the vertex array
-    target.draw(backgroundLayerVertices, states);
-    target.draw(mainLayerVertices, states);
+    // Only draw the chunks intersecting the view
+    IntRect visible = getVisibleChunks(target.getView());
+    Vector2u chunkCount = tiles.getChunkCount();
+
+    drawnChunks = 0;
+    for (int layer = 0; layer < 2; layer++) {
+        for (int chunkY = visible.position.y; chunkY < visible.position.y + visible.size.y; chunkY++) {
+            for (int chunkX = visible.position.x; chunkX < visible.position.x + visible.size.x; chunkX++) {
+                const TileChunk* chunk = tiles.getChunk(chunkX + chunkY * chunkCount.x);
+                if (chunk == nullptr) {
+                    continue;
+                }
+                const VertexBuffer& buffer = layer == 0 ? chunk->backgroundLayerBuffer : chunk->mainLayerBuffer;
+                const vector<Vertex>& vertices = layer == 0 ? chunk->backgroundLayerVertices : chunk->mainLayerVertices;
+                if (buffer.getVertexCount() > 0) {
+                    target.draw(buffer, states);
+                } else if (!vertices.empty()) {
+                    target.draw(vertices.data(), vertices.size(), PrimitiveType::Triangles, states);
+                }
+                if (layer == 1) {
+                    drawnChunks++;
+                }
+            }
+        }
+    }
 }
 
 void Level::updateEntities(Player& player, RenderWindow& window, bool& gameFinished) {
@@ -159,10 +279,55 @@ void Level::updateEntities(Player& player, RenderWindow& window, bool& gameFinis
     // } 
 } 
 
-vector<vector<Tile>> Level::getTiles() {
+const TileMap& Level::getTiles() const {
     return tiles;
 }
 
+/**
+ * Range of tiles touched by an area in pixels
+ */
+IntRect getTileRange(FloatRect area) {
+    int startX = floor(area.position.x / TILE_SIZE.x);
+    int startY = floor(area.position.y / TILE_SIZE.y);
+    int endX = floor((area.position.x + area.size.x) / TILE_SIZE.x);
+    int endY = floor((area.position.y + area.size.y) / TILE_SIZE.y);
+    return IntRect({startX, startY}, {endX - startX + 1, endY - startY + 1});
+}
+
+/**
+ * Collision mask of the tile at grid position (x, y), unloaded tiles are fully solid
+ */
+const TileMask& Level::getTileMask(int x, int y) const {
+    if (tiles.getFlags(x, y) & TILE_UNLOADED) {
+        return FULL_TILE_MASK;
+    }
+    return tileMasks.getMask(tiles.getTileType(x, y));
+}
+
+/**
+ * Collision queries, candidates come from the occupancy bits and only those are tested against their mask
+ */
+bool Level::anySolid(FloatRect area) const {
+    return tiles.findTiles(getTileRange(area), TILE_SOLID, [&](int x, int y) {
+        return getTileMask(x, y).overlaps(getTileOrigin(x, y), area);
+    });
+}
+
+bool Level::anyDangerous(FloatRect area) const {
+    return tiles.findTiles(getTileRange(area), TILE_DANGEROUS, [&](int x, int y) {
+        return getTileMask(x, y).overlaps(getTileOrigin(x, y), area);
+    });
+}
+
+/**
+ * Distance between the bottom of a box and the top of the first solid tile below it
+ * Returns INFINITY when there is none within maxDistance
+ */
+float Level::distanceToGround(FloatRect box, float maxDistance) const {
+    TileHit ground = firstSolidBelow(*this, box, maxDistance);
+    return ground.hit ? ground.distance : INFINITY;
+}
+
 // array<MapEntity*, 10>& Level::getEntities() {
 //     return entities;
 // }
@@ -175,10 +340,60 @@ Vector2u Level::getSpawnPosition() const {
     return spawnPosition;
 }
 
-VertexArray& Level::getMainLayerVertices() {
-    return mainLayerVertices;
+bool Level::isStreamed() const {
+    return streamer != nullptr;
+}
+
+/**
+ * Range of chunks intersecting a view, clamped to the level
+ */
+IntRect Level::getVisibleChunks(const View& view) const {
+    Vector2f viewPosition = view.getCenter() - view.getSize() / 2.0f;
+    Vector2f viewEnd = viewPosition + view.getSize();
+    Vector2u chunkCount = tiles.getChunkCount();
+    int startX = max(0, (int) floor(viewPosition.x / (CHUNK_SIZE * TILE_SIZE.x)));
+    int startY = max(0, (int) floor(viewPosition.y / (CHUNK_SIZE * TILE_SIZE.y)));
+    int endX = min((int) chunkCount.x - 1, (int) floor(viewEnd.x / (CHUNK_SIZE * TILE_SIZE.x)));
+    int endY = min((int) chunkCount.y - 1, (int) floor(viewEnd.y / (CHUNK_SIZE * TILE_SIZE.y)));
+    return IntRect({startX, startY}, {max(0, endX - startX + 1), max(0, endY - startY + 1)});
+}
+
+size_t Level::getDrawnChunks() const {
+    return drawnChunks;
 }
 
-Texture& Level::getTileset() {
+size_t Level::getResidentBytes() const {
+    return residentBytes;
+}
+
+size_t Level::getPeakResidentBytes() const {
+    return peakResidentBytes;
+}
+
+size_t Level::getSynchronousLoads() const {
+    return streamer != nullptr ? streamer->getSynchronousLoads() : 0;
+}
+
+/**
+ * Memory the tiles and vertices of the whole level would take if it was fully loaded
+ * Vertices are estimated from the ratio of vertices the mesh builder kept so far
+ */
+size_t Level::getFullLevelBytes() const {
+    return (size_t) tiles.getChunkCount().x * tiles.getChunkCount().y * sizeof(TileChunk) 
+        + (size_t) size.x * size.y * 2 * 6 * sizeof(Vertex) * vertexCount / max<size_t>(1, fullVertexCount);
+}
+
+const Arena& Level::getArena() const {
+    return arena;
+}
+
+ObjectPool<TileChunk>& Level::getChunkPool() {
+    return *chunkPool;
+}
+
+/**
+ * Tileset image, packed into the texture atlas by the game
+ */
+const AssetHandle& Level::getTileset() const {
     return tileset;
 }
\ No newline at end of file
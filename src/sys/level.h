@@ -1,11 +1,16 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
-#include "tile.h"
-#include "../entities/mapEntity.h"
+#include "tileMap.h"
+#include "chunkStreamer.h"
+#include "tileMesh.h"
+#include "tileMask.h"
+#include "../util/arena.h"
+#include "assetCache.h"
+#include "textureAtlas.h"
+#include "../entities/entityWorld.h"
 #include <iostream>
 
-class MapEntity;
 class Player;
 
 #define BACKGROUND_SPRITE_FILENAME "assets/backgrounds/sky.png"
@@ -15,27 +20,70 @@ using namespace sf;
 
 class Level : public Drawable, public Transformable {
     private:
-        vector<vector<Tile>> tiles;
-        VertexArray mainLayerVertices; 
-        VertexArray backgroundLayerVertices;
+        Arena arena; // Entities and tutorial texts, freed all at once with the level
+        unique_ptr<ObjectPool<TileChunk>> chunkPool; // Chunks of the level, recycled while streaming
+        TileMap tiles;
+        unique_ptr<ChunkStreamer> streamer;
+        vector<int> installedChunks;
+        vector<int> evictedChunks;
+        size_t residentBytes = 0;
+        size_t peakResidentBytes = 0;
+        mutable size_t drawnChunks = 0;
+
+        TileMeshBuilder meshBuilder;
+        TileMaskSet tileMasks;
+        size_t vertexCount = 0; // Vertices built by the mesh builder for the resident chunks
+        size_t fullVertexCount = 0; // Vertices the same chunks would take with 2 triangles per cell
         
-        Texture tileset;
-        Texture backgroundTexture;
+        bool graphicsLoaded = false;
+        AssetHandle tileset;
+        const TextureAtlas* atlas = nullptr; // Holds the tileset and the background once graphics are loaded
         Vector2u size;
         Vector2u spawnPosition;
         virtual void draw(RenderTarget& target, RenderStates states) const override;
+        void installChunk(int index);
+        void buildChunkMesh(int index);
+        void uploadVertices(VertexBuffer& buffer, vector<Vertex>& vertices);
+        Vector2u getChunkTiles(int index) const;
+        size_t getChunkVertexCount(const TileChunk& chunk) const;
+        size_t getChunkBytes(const TileChunk& chunk) const;
+        EntitySpawn createEntity(string_view tag, Vector2f spawnPosition, string_view tutorialText);
 
     public:
         Level();
         Level(string levelFilename, string tilesetFilename);
-        vector<vector<Tile>> getTiles();
-        vector<MapEntity*> entities;
+        // The tiles and the loader thread hold chunks of the pool, a level stays where it was made
+        Level(const Level&) = delete;
+        Level& operator=(const Level&) = delete;
+        Level(Level&&) = delete;
+        Level& operator=(Level&&) = delete;
+        static void prefetchAssets(string tilesetFilename);
+        void loadGraphics(const TextureAtlas& atlas);
+        const TileMap& getTiles() const;
+        const TileMask& getTileMask(int x, int y) const;
+        bool anySolid(FloatRect area) const;
+        bool anyDangerous(FloatRect area) const;
+        float distanceToGround(FloatRect box, float maxDistance) const;
+        ArenaArray<EntitySpawn> entities; // Spawned into the entity world of every game playing the level
         Vector2u getSize() const;
         Vector2u getSpawnPosition() const;
-        VertexArray& getMainLayerVertices();
-        Texture& getTileset();
-        Sprite& getBackground();
+        void updateStreaming(FloatRect region);
+        void requireTiles(FloatRect area);
+        void loadAllChunks();
+        void setResidencyBudget(size_t chunks);
+        bool isStreamed() const;
+        IntRect getVisibleChunks(const View& view) const;
+        size_t getDrawnChunks() const;
+        size_t getResidentBytes() const;
+        size_t getPeakResidentBytes() const;
+        size_t getSynchronousLoads() const;
+        size_t getFullLevelBytes() const;
+        const Arena& getArena() const;
+        ObjectPool<TileChunk>& getChunkPool();
+        const AssetHandle& getTileset() const;
         void updateEntities(Player& player, RenderWindow& window, bool& gameFinished);
 };
 
+IntRect getTileRange(FloatRect area);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "levelFile.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+bool isBinaryLevelFile(const string& filename) {
+    string extension = LEVEL_BINARY_EXTENSION;
+    return filename.size() >= extension.size() 
+        && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+ * Parse a text .lvl file
+ * First line is the level size and the spawn position, then size.y rows of the main layer, 
+ * size.y rows of the background layer and one entity per line
+ */
+LevelData readTextLevel(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open level file");
+    }
+
+    LevelData level;
+    string line;
+    unsigned int y = -1;
+
+    while (getline(file, line)) {
+        istringstream iss(line);
+        string stringValue;
+        unsigned int x = 0;
+        LevelEntityData entity;
+
+        while (iss >> stringValue) {
+            if (y == (unsigned int) -1) {
+                int value = stoi(stringValue);
+                if (value < 0) {
+                    throw runtime_error("Malformed level file header");
+                }
+                // Read level size from the first line of the file
+                if (x == 0) {
+                    level.size.x = value;
+                } else if (x == 1) {
+                    level.size.y = value;
+                    level.mainLayer = vector<int16_t>(level.size.x * level.size.y, -1);
+                    level.backgroundLayer = vector<int16_t>(level.size.x * level.size.y, -1);
+                // Read spawn position
+                } else if (x == 2) {
+                    level.spawnPosition.x = value;
+                } else if (x == 3) {
+                    level.spawnPosition.y = value;
+                }
+            } else if (y < level.size.y * 2 && x >= level.size.x) {
+                throw runtime_error("Malformed level file, row is wider than the level");
+            } else if (y < level.size.y) {
+                level.mainLayer[x + y * level.size.x] = stoi(stringValue);
+            } else if (y < level.size.y * 2) { // Background layer
+                level.backgroundLayer[x + (y - level.size.y) * level.size.x] = stoi(stringValue);
+            } else { // Entities
+                if (x == 0) {
+                    entity.tag = stringValue;
+                } else if (x == 1) {
+                    entity.position.x = stoi(stringValue);
+                } else if (x == 2) {
+                    entity.position.y = stoi(stringValue);
+                    // The rest of the line is the tutorial text
+                    getline(iss, entity.tutorialText);
+                    level.entities.push_back(entity);
+                }
+            }
+            x++;
+        }
+        y++;
+    }
+
+    return level;
+}
+
+/**
+ * Check the header of a mapped .lvlb file and locate its sections, nothing is copied
+ */
+LevelFileView viewBinaryLevel(const unsigned char* data, size_t size) {
+    if (size < sizeof(LevelFileHeader)) {
+        throw runtime_error("Level file is too small");
+    }
+
+    LevelFileView view;
+    view.header = (const LevelFileHeader*) data;
+    if (view.header->magic != LEVEL_BINARY_MAGIC) {
+        throw runtime_error("Not a compiled level file");
+    }
+    if (view.header->version != LEVEL_BINARY_VERSION) {
+        throw runtime_error("Unsupported compiled level version, recompile the level");
+    }
+
+    if (view.header->chunkSize != CHUNK_SIZE) {
+        throw runtime_error("Level file was compiled with another chunk size");
+    }
+
+    view.chunkCount = getChunkCount({view.header->width, view.header->height});
+    size_t chunkCount = (size_t) view.chunkCount.x * view.chunkCount.y;
+    size_t expectedSize = sizeof(LevelFileHeader) + chunkCount * sizeof(LevelFileChunk)
+        + view.header->entityCount * sizeof(LevelFileEntity) + view.header->stringPoolSize;
+    if (size < expectedSize) {
+        throw runtime_error("Level file is truncated");
+    }
+
+    view.chunks = (const LevelFileChunk*) (data + sizeof(LevelFileHeader));
+    view.entities = (const LevelFileEntity*) (view.chunks + chunkCount);
+    view.stringPool = (const char*) (view.entities + view.header->entityCount);
+
+    // Entity texts are views into the string pool, they must not point past it
+    for (uint32_t i = 0; i < view.header->entityCount; i++) {
+        const LevelFileEntity& entity = view.entities[i];
+        if ((uint64_t) entity.textOffset + entity.textLength > view.header->stringPoolSize) {
+            throw runtime_error("Level file has an entity text outside of the string pool");
+        }
+    }
+    return view;
+}
+
+Vector2u getChunkCount(Vector2u levelSize) {
+    return {(levelSize.x + CHUNK_SIZE - 1) / CHUNK_SIZE, (levelSize.y + CHUNK_SIZE - 1) / CHUNK_SIZE};
+}
+
+void writeBinaryLevel(const string& filename, const LevelData& level) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open " + filename);
+    }
+
+    // Intern tutorial strings so that repeated texts are only stored once in the pool
+    string stringPool;
+    unordered_map<string, uint32_t> internedStrings;
+    vector<LevelFileEntity> entities;
+
+    for (const LevelEntityData& entityData : level.entities) {
+        LevelFileEntity entity = {};
+        memcpy(entity.tag, entityData.tag.c_str(), min<size_t>(2, entityData.tag.size()));
+        entity.x = entityData.position.x;
+        entity.y = entityData.position.y;
+        entity.textLength = entityData.tutorialText.size();
+
+        auto interned = internedStrings.find(entityData.tutorialText);
+        if (interned != internedStrings.end()) {
+            entity.textOffset = interned->second;
+        } else {
+            entity.textOffset = stringPool.size();
+            internedStrings[entityData.tutorialText] = entity.textOffset;
+            stringPool += entityData.tutorialText;
+        }
+        entities.push_back(entity);
+    }
+
+    LevelFileHeader header = {};
+    header.magic = LEVEL_BINARY_MAGIC;
+    header.version = LEVEL_BINARY_VERSION;
+    header.width = level.size.x;
+    header.height = level.size.y;
+    header.spawnX = level.spawnPosition.x;
+    header.spawnY = level.spawnPosition.y;
+    header.chunkSize = CHUNK_SIZE;
+    header.entityCount = entities.size();
+    header.stringPoolSize = stringPool.size();
+
+    file.write((const char*) &header, sizeof(header));
+
+    // Cut both row-major layers into chunks
+    Vector2u chunkCount = getChunkCount(level.size);
+    for (unsigned int chunkY = 0; chunkY < chunkCount.y; chunkY++) {
+        for (unsigned int chunkX = 0; chunkX < chunkCount.x; chunkX++) {
+            LevelFileChunk chunk;
+            for (unsigned int y = 0; y < CHUNK_SIZE; y++) {
+                for (unsigned int x = 0; x < CHUNK_SIZE; x++) {
+                    unsigned int levelX = chunkX * CHUNK_SIZE + x;
+                    unsigned int levelY = chunkY * CHUNK_SIZE + y;
+                    bool inside = levelX < level.size.x && levelY < level.size.y;
+                    chunk.tileTypes[x + y * CHUNK_SIZE] = inside ? level.mainLayer[levelX + levelY * level.size.x] : -1;
+                    chunk.backgroundTileTypes[x + y * CHUNK_SIZE] = inside ? level.backgroundLayer[levelX + levelY * level.size.x] : -1;
+                }
+            }
+            file.write((const char*) &chunk, sizeof(chunk));
+        }
+    }
+
+    file.write((const char*) entities.data(), entities.size() * sizeof(LevelFileEntity));
+    file.write(stringPool.data(), stringPool.size());
+
+    if (!file) {
+        throw runtime_error("Failed to write " + filename);
+    }
+}
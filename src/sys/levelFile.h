@@ -0,0 +1,83 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace sf;
+
+/**
+ * Compiled level format (.lvlb), all values little endian:
+ *  - LevelFileHeader
+ *  - chunk table, chunks of CHUNK_SIZE * CHUNK_SIZE tiles stored row by row of chunks,
+ *    each chunk holds its main and background layer tile types (int16, row-major, -1 past the level edges)
+ *  - entity table, entityCount LevelFileEntity
+ *  - string pool, tutorial strings referenced by offset and length (identical strings are stored once)
+ */
+#define LEVEL_BINARY_EXTENSION ".lvlb"
+#define LEVEL_BINARY_MAGIC 0x4C564C53 // "SLVL"
+#define LEVEL_BINARY_VERSION 2
+
+#define CHUNK_SIZE 32 // Tiles per chunk side
+
+struct LevelFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t spawnX;
+    uint32_t spawnY;
+    uint32_t chunkSize;
+    uint32_t entityCount;
+    uint32_t stringPoolSize;
+    uint32_t reserved;
+};
+
+struct LevelFileChunk {
+    int16_t tileTypes[CHUNK_SIZE * CHUNK_SIZE];
+    int16_t backgroundTileTypes[CHUNK_SIZE * CHUNK_SIZE];
+};
+
+struct LevelFileEntity {
+    char tag[2]; // Same two letters as in .lvl files, "TA" or "SF"
+    uint8_t padding[2];
+    int32_t x;
+    int32_t y;
+    uint32_t textOffset;
+    uint32_t textLength;
+};
+
+struct LevelEntityData {
+    string tag;
+    Vector2f position;
+    string tutorialText;
+};
+
+// Level content read from a text .lvl file
+struct LevelData {
+    Vector2u size;
+    Vector2u spawnPosition;
+    vector<int16_t> mainLayer;
+    vector<int16_t> backgroundLayer;
+    vector<LevelEntityData> entities;
+};
+
+// Pointers into a mapped .lvlb file
+struct LevelFileView {
+    const LevelFileHeader* header;
+    Vector2u chunkCount;
+    const LevelFileChunk* chunks;
+    const LevelFileEntity* entities;
+    const char* stringPool;
+};
+
+bool isBinaryLevelFile(const string& filename);
+LevelData readTextLevel(const string& filename);
+LevelFileView viewBinaryLevel(const unsigned char* data, size_t size);
+Vector2u getChunkCount(Vector2u levelSize);
+void writeBinaryLevel(const string& filename, const LevelData& level);
+
+#endif
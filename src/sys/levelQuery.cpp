@@ -0,0 +1,168 @@
+#include "levelQuery.h"
+#include <algorithm>
+
+/**
+ * Walk the cells of a grid crossed by a ray in order (digital differential analyzer)
+ * visit(cell, distance, normal) gets the distance at which the ray enters the cell and the side it enters through
+ * The walk stops when visit returns true or past maxDistance, direction must be normalized
+ * Cells can be wider than tall, each axis steps by its own cell dimension
+ */
+template <typename Visit> static bool traverseGrid(Vector2f origin, Vector2f direction, float maxDistance, Vector2f cellSize, Vector2i normal, Visit visit) {
+    Vector2i cell = {(int) floor(origin.x / cellSize.x), (int) floor(origin.y / cellSize.y)};
+    Vector2i step = {direction.x > 0 ? 1 : -1, direction.y > 0 ? 1 : -1};
+
+    // Distance along the ray to the next vertical and horizontal grid lines, and between two of them
+    Vector2f next = {
+        direction.x != 0 ? ((step.x > 0 ? cell.x + 1 : cell.x) * cellSize.x - origin.x) / direction.x : INFINITY,
+        direction.y != 0 ? ((step.y > 0 ? cell.y + 1 : cell.y) * cellSize.y - origin.y) / direction.y : INFINITY
+    };
+    Vector2f delta = {
+        direction.x != 0 ? cellSize.x / abs(direction.x) : INFINITY, 
+        direction.y != 0 ? cellSize.y / abs(direction.y) : INFINITY
+    };
+
+    float distance = 0;
+    while (distance <= maxDistance) {
+        if (visit(cell, distance, normal)) {
+            return true;
+        }
+        if (next.x < next.y) {
+            distance = next.x;
+            next.x += delta.x;
+            cell.x += step.x;
+            normal = {-step.x, 0};
+        } else {
+            distance = next.y;
+            next.y += delta.y;
+            cell.y += step.y;
+            normal = {0, -step.y};
+        }
+    }
+    return false;
+}
+
+/**
+ * First tile with a property whose solid pixels are crossed by a ray
+ * Tiles are walked one by one, the pixels of a candidate tile are then walked the same way through its mask
+ * Rays stop at the level edges
+ */
+TileHit raycast(const Level& level, Vector2f origin, Vector2f direction, float maxDistance, TileFlag property) {
+    TileHit result;
+    float length = hypot(direction.x, direction.y);
+    if (length == 0) {
+        return result;
+    }
+    direction = direction / length;
+    const TileMap& tiles = level.getTiles();
+
+    traverseGrid(origin, direction, maxDistance, Vector2f(TILE_SIZE), {0, 0}, [&](Vector2i tile, float distance, Vector2i normal) {
+        if (!tiles.contains(tile.x, tile.y)) {
+            return true;
+        }
+        if (!(tiles.getFlags(tile.x, tile.y) & property)) {
+            return false;
+        }
+
+        const TileMask& mask = level.getTileMask(tile.x, tile.y);
+        Vector2f tileOrigin = getTileOrigin(tile.x, tile.y);
+        // Keep the entry point inside the tile despite rounding, by as little as possible since grazing rays turn it into distance
+        Vector2f entry = origin + direction * distance - tileOrigin;
+        entry = {clamp(entry.x, 0.0f, nextafter((float) TILE_SIZE.x, 0.0f)), clamp(entry.y, 0.0f, nextafter((float) TILE_SIZE.y, 0.0f))};
+
+        traverseGrid(entry, direction, maxDistance - distance, {1, 1}, normal, [&](Vector2i pixel, float pixelDistance, Vector2i pixelNormal) {
+            if (pixel.x < 0 || pixel.y < 0 || pixel.x >= (int) TILE_SIZE.x || pixel.y >= (int) TILE_SIZE.y) {
+                return true;
+            }
+            if (mask.rows[pixel.y] >> pixel.x & 1) {
+                result = {true, tile, tiles.getTileType(tile.x, tile.y), tileOrigin + entry + direction * pixelDistance, 
+                    pixelNormal, distance + pixelDistance};
+                return true;
+            }
+            return false;
+        });
+        return result.hit;
+    });
+    return result;
+}
+
+TileHit castSegment(const Level& level, Vector2f start, Vector2f end, TileFlag property) {
+    Vector2f direction = end - start;
+    return raycast(level, start, direction, hypot(direction.x, direction.y), property);
+}
+
+bool hasLineOfSight(const Level& level, Vector2f start, Vector2f end) {
+    return !castSegment(level, start, end).hit;
+}
+
+/**
+ * First solid pixel straight below a point, e.g. where something falling from there lands
+ */
+TileHit firstSolidBelow(const Level& level, Vector2f point, float maxDistance) {
+    return raycast(level, point, {0, 1}, maxDistance, TILE_SOLID);
+}
+
+/**
+ * First solid pixel below a box in the columns it covers, e.g. where the box lands if it falls
+ * The distance is measured from the bottom of the box, tiles whose solid pixels start above it are ignored
+ * Rows of tiles are searched from the top, the search stops at the first row with a hit since the next ones are further away
+ */
+TileHit firstSolidBelow(const Level& level, FloatRect box, float maxDistance) {
+    TileHit result;
+    float bottom = box.position.y + box.size.y;
+    IntRect columns = getTileRange(box);
+    int startRow = floor(bottom / TILE_SIZE.y);
+    int endRow = floor((bottom + maxDistance) / TILE_SIZE.y);
+    const TileMap& tiles = level.getTiles();
+
+    for (int row = startRow; row <= endRow; row++) {
+        float distance = INFINITY;
+        tiles.findTiles(IntRect({columns.position.x, row}, {columns.size.x, 1}), TILE_SOLID, [&](int x, int y) {
+            float top, end;
+            if (level.getTileMask(x, y).getExtent(getTileOrigin(x, y), box, 'y', top, end) && top >= bottom && top - bottom < distance) {
+                distance = top - bottom;
+                result.tile = {x, y};
+            }
+            return false;
+        });
+        if (distance <= maxDistance) {
+            result.hit = true;
+            result.tileType = tiles.getTileType(result.tile.x, result.tile.y);
+            result.position = {box.position.x + box.size.x / 2, bottom + distance};
+            result.normal = {0, -1};
+            result.distance = distance;
+            return result;
+        }
+    }
+    return result;
+}
+
+/**
+ * Overlap between a box and the solid pixels of the tile at grid position (x, y)
+ * Returns false when they do not overlap
+ */
+bool getTileOverlap(const Level& level, int x, int y, FloatRect box, TileHit& hit) {
+    const TileMask& mask = level.getTileMask(x, y);
+    Vector2f tileOrigin = getTileOrigin(x, y);
+    float startX, endX, startY, endY;
+    if (!mask.overlaps(tileOrigin, box) || !mask.getExtent(tileOrigin, box, 'x', startX, endX) || !mask.getExtent(tileOrigin, box, 'y', startY, endY)) {
+        return false;
+    }
+
+    // How far the box has to move on each side to get out of the solid pixels
+    float left = box.position.x + box.size.x - startX;
+    float right = endX - box.position.x;
+    float up = box.position.y + box.size.y - startY;
+    float down = endY - box.position.y;
+    float depth = min({left, right, up, down});
+
+    Vector2f overlapStart = {max(startX, box.position.x), max(startY, box.position.y)};
+    Vector2f overlapEnd = {min(endX, box.position.x + box.size.x), min(endY, box.position.y + box.size.y)};
+
+    hit.hit = true;
+    hit.tile = {x, y};
+    hit.tileType = level.getTiles().getTileType(x, y);
+    hit.position = (overlapStart + overlapEnd) / 2.0f;
+    hit.normal = depth == left ? Vector2i(-1, 0) : depth == right ? Vector2i(1, 0) : depth == up ? Vector2i(0, -1) : Vector2i(0, 1);
+    hit.distance = depth;
+    return true;
+}
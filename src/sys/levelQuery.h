@@ -0,0 +1,48 @@
+#ifndef LEVEL_QUERY_H
+#define LEVEL_QUERY_H
+
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include "level.h"
+
+using namespace std;
+using namespace sf;
+
+/**
+ * Result of a spatial query against the tiles of a level
+ */
+struct TileHit {
+    bool hit = false;
+    Vector2i tile;          // Grid position of the tile
+    int tileType = -1;      // -1 for tiles of chunks that are not loaded
+    Vector2f position;      // Point of impact in pixels, or center of the overlap for box queries
+    Vector2i normal;        // Side of the tile that was hit, (0, 0) when the query started inside it
+    float distance = 0;     // Distance travelled to the impact, or penetration depth for box queries
+};
+
+TileHit raycast(const Level& level, Vector2f origin, Vector2f direction, float maxDistance, TileFlag property = TILE_SOLID);
+TileHit castSegment(const Level& level, Vector2f start, Vector2f end, TileFlag property = TILE_SOLID);
+bool hasLineOfSight(const Level& level, Vector2f start, Vector2f end);
+TileHit firstSolidBelow(const Level& level, Vector2f point, float maxDistance);
+TileHit firstSolidBelow(const Level& level, FloatRect box, float maxDistance);
+bool getTileOverlap(const Level& level, int x, int y, FloatRect box, TileHit& hit);
+
+/**
+ * Call callback(const TileHit&) for every tile with a property whose solid pixels overlap a box
+ * The normal of each hit is the shortest way out of the tile for the box and distance how deep it is in
+ * Stops as soon as the callback returns true, returns the number of tiles visited
+ */
+template <typename Callback> int forEachOverlap(const Level& level, FloatRect box, TileFlag property, Callback callback) {
+    int count = 0;
+    level.getTiles().findTiles(getTileRange(box), property, [&](int x, int y) {
+        TileHit hit;
+        if (!getTileOverlap(level, x, y, box, hit)) {
+            return false;
+        }
+        count++;
+        return (bool) callback(hit);
+    });
+    return count;
+}
+
+#endif
@@ -1,40 +1,35 @@
 #include "pauseMenu.h"
 
-PauseMenu::PauseMenu() : continueButton(GAME_FONT), retryButton(GAME_FONT), quitButton(GAME_FONT) {
-    menu = RectangleShape(Vector2f(SCREEN_RESOLUTION) - Vector2f({100, 100}));
-    menu.setFillColor(Color(250, 150, 100, 100));
-    menu.setPosition({50, 50});
+/**
+ * Lay out the menu in the HUD of the game, hidden until the game is paused
+ */
+void PauseMenu::addToHud(Hud& hud) {
+    menu = hud.addRectangle(FloatRect({50, 50}, Vector2f(SCREEN_RESOLUTION) - Vector2f({100, 100})), Color(250, 150, 100, 100));
 
-    circleCursor = CircleShape(10.f);
-    circleCursor.setOrigin(circleCursor.getLocalBounds().getCenter());
+    continueButton = hud.addText("CONTINUE", {SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2 - 50});
+    retryButton = hud.addText("RETRY", {SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2});
+    quitButton = hud.addText("QUIT", {SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2 + 50});
 
-    continueButton = Text(GAME_FONT);
-    continueButton.setString("CONTINUE");
-    continueButton.setOrigin(continueButton.getLocalBounds().getCenter());
-    continueButton.setPosition({SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2 - 50});
+    circleCursor = hud.addCircle({70, (float) SCREEN_RESOLUTION.y / 2 - 50}, 10.f, Color::White);
 
-    retryButton = Text(GAME_FONT);
-    retryButton.setString("RETRY");
-    retryButton.setOrigin(retryButton.getLocalBounds().getCenter());
-    retryButton.setPosition({SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2});
-
-    quitButton = Text(GAME_FONT);
-    quitButton.setString("QUIT");
-    quitButton.setOrigin(quitButton.getLocalBounds().getCenter());
-    quitButton.setPosition({SCREEN_RESOLUTION.x / 2, SCREEN_RESOLUTION.y / 2 + 50});
+    for (HudElement button : {continueButton, retryButton, quitButton}) {
+        hud.setOrigin(button, {0.5f, 0.5f});
+    }
+    updateHud(hud, false);
 }
 
-void PauseMenu::update(float deltaTime, bool& pause, Player& player, 
-        Vector2f levelSpawnPosition, Input& input, RenderWindow& window) {
+/**
+ * Move the cursor and handle the selected button, retrying is left to the game which restores the start of the level
+ */
+void PauseMenu::update(bool& pause, bool& quit, bool& retry, const Input& input) {
 
     if (input.isKeyTriggered(Keyboard::Scancode::Space) || input.isKeyTriggered(Keyboard::Scancode::Enter)) {
-        bool deathAnimationFinished = false;
         switch (pauseMenuIndex) {
             case 1:
-                window.close();
+                quit = true;
                 break;
             case 0:
-                player.kill();
+                retry = true;
                 pause = false;
                 break;
             default:
@@ -53,15 +48,16 @@ void PauseMenu::update(float deltaTime, bool& pause, Player& player,
             pauseMenuIndex--;
         }
     }
-    
-    circleCursor.setPosition({70, (float) SCREEN_RESOLUTION.y / 2 + pauseMenuIndex * 50});
+}
 
-    window.setView(window.getDefaultView());
-    window.draw(menu);
-    window.draw(continueButton);
-    window.draw(retryButton);
-    window.draw(quitButton);
-    window.draw(circleCursor);
+/**
+ * Show or hide the menu, the cursor follows the selected button
+ */
+void PauseMenu::updateHud(Hud& hud, bool visible) const {
+    for (HudElement element : {menu, continueButton, retryButton, quitButton, circleCursor}) {
+        hud.setVisible(element, visible);
+    }
+    hud.setPosition(circleCursor, {70, (float) SCREEN_RESOLUTION.y / 2 + pauseMenuIndex * 50});
 }
 
 void PauseMenu::resetCursor() {
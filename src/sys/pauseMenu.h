@@ -3,24 +3,23 @@
 
 #include "../entities/player.h"
 #include "input.h"
+#include "hud.h"
 
 class PauseMenu {
     private:
-        RectangleShape menu;
-        CircleShape circleCursor;
-        Text continueButton;
-        Text retryButton;
-        Text quitButton;
+        HudElement menu;
+        HudElement circleCursor;
+        HudElement continueButton;
+        HudElement retryButton;
+        HudElement quitButton;
 
         int pauseMenuIndex = -1;
         Vector2f pauseMenuCursorTimer = {0, 0};
 
-        Vector2f levelSpawnPosition;
-
     public:
-        PauseMenu();
-        void update(float deltaTime, bool& pause, Player& player, 
-            Vector2f levelSpawnPosition, Input& input, RenderWindow& window);
+        void addToHud(Hud& hud);
+        void update(bool& pause, bool& quit, bool& retry, const Input& input);
+        void updateHud(Hud& hud, bool visible) const;
         void resetCursor();
 };
 
@@ -0,0 +1,148 @@
+#include "rewindBuffer.h"
+#include <cstring>
+#include <stdexcept>
+
+static void writeVarint(vector<uint8_t>& output, size_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        output.push_back(byte);
+    } while (value != 0);
+}
+
+static size_t readVarint(const uint8_t* data, size_t& position) {
+    size_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = data[position++];
+        value |= (size_t) (byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+/**
+ * All the memory is allocated here, pushing snapshots never allocates
+ */
+RewindBuffer::RewindBuffer(size_t capacity, size_t maxSnapshots) : bytes(capacity), records(maxSnapshots) {
+    memset((void*) &newest, 0, sizeof(GameSnapshot));
+    delta.reserve(sizeof(GameSnapshot) * 2);
+}
+
+void RewindBuffer::dropOldest() {
+    usedBytes -= records[firstRecord].size;
+    firstRecord = (firstRecord + 1) % records.size();
+    recordCount--;
+}
+
+/**
+ * Add a snapshot after the newest one
+ */
+void RewindBuffer::push(const GameSnapshot& snapshot) {
+    const uint8_t* current = (const uint8_t*) &snapshot;
+    const uint8_t* previous = (const uint8_t*) &newest;
+
+    delta.clear();
+    size_t start = 0;
+    while (start < sizeof(GameSnapshot)) {
+        size_t changedStart = start;
+        while (changedStart < sizeof(GameSnapshot) && current[changedStart] == previous[changedStart]) {
+            changedStart++;
+        }
+        if (changedStart == sizeof(GameSnapshot)) {
+            break;
+        }
+        size_t changedEnd = changedStart;
+        while (changedEnd < sizeof(GameSnapshot) && current[changedEnd] != previous[changedEnd]) {
+            changedEnd++;
+        }
+        writeVarint(delta, changedStart - start);
+        writeVarint(delta, changedEnd - changedStart);
+        for (size_t i = changedStart; i < changedEnd; i++) {
+            delta.push_back(current[i] ^ previous[i]);
+        }
+        start = changedEnd;
+    }
+    if (delta.size() > bytes.size()) {
+        throw runtime_error("Snapshot does not fit in the rewind buffer");
+    }
+
+    if (recordCount == records.size()) {
+        dropOldest();
+    }
+    // Records are never split, the end of the ring is left unused when the next one does not fit
+    size_t offset = writeOffset;
+    if (offset + delta.size() > bytes.size()) {
+        while (recordCount > 0 && records[firstRecord].offset >= writeOffset) {
+            dropOldest();
+        }
+        offset = 0;
+    }
+    while (recordCount > 0 && records[firstRecord].offset >= offset && records[firstRecord].offset < offset + delta.size()) {
+        dropOldest();
+    }
+
+    memcpy(bytes.data() + offset, delta.data(), delta.size());
+    records[(firstRecord + recordCount) % records.size()] = {(uint32_t) offset, (uint32_t) delta.size()};
+    recordCount++;
+    usedBytes += delta.size();
+    writeOffset = offset + delta.size();
+    newest = snapshot;
+}
+
+/**
+ * Drop the newest snapshot and give the one before it, which becomes the newest
+ * Returns false when there is nothing older to go back to
+ */
+bool RewindBuffer::rewind(GameSnapshot& snapshot) {
+    if (recordCount < 2) {
+        return false;
+    }
+    const Record& record = records[(firstRecord + recordCount - 1) % records.size()];
+    const uint8_t* data = bytes.data() + record.offset;
+    uint8_t* target = (uint8_t*) &newest;
+
+    size_t position = 0;
+    size_t start = 0;
+    while (position < record.size) {
+        start += readVarint(data, position);
+        size_t changed = readVarint(data, position);
+        for (size_t i = 0; i < changed; i++) {
+            target[start + i] ^= data[position + i];
+        }
+        position += changed;
+        start += changed;
+    }
+
+    writeOffset = record.offset;
+    usedBytes -= record.size;
+    recordCount--;
+    snapshot = newest;
+    return true;
+}
+
+void RewindBuffer::clear() {
+    firstRecord = 0;
+    recordCount = 0;
+    writeOffset = 0;
+    usedBytes = 0;
+}
+
+size_t RewindBuffer::getSnapshotCount() const {
+    return recordCount;
+}
+
+size_t RewindBuffer::getUsedBytes() const {
+    return usedBytes;
+}
+
+/**
+ * Memory taken by the buffer whatever it holds
+ */
+size_t RewindBuffer::getMemoryBudget() const {
+    return bytes.size() + records.size() * sizeof(Record) + sizeof(GameSnapshot) + delta.capacity();
+}
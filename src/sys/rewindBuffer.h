@@ -0,0 +1,46 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include <cstdint>
+#include <vector>
+#include "snapshot.h"
+
+using namespace std;
+
+/**
+ * History of the last snapshots in a fixed amount of memory, the oldest ones are dropped when it is full
+ *
+ * Each snapshot is stored as the XOR with the one before it, with the runs of unchanged bytes skipped:
+ * varint (unchanged bytes), varint (changed bytes), then the changed bytes XORed with the previous snapshot
+ * XOR works both ways, so going back one snapshot only decodes the newest record, no keyframe is needed
+ */
+class RewindBuffer {
+    private:
+        struct Record {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        vector<uint8_t> bytes; // Ring of encoded snapshots
+        vector<Record> records; // Ring of the records in bytes, oldest first
+        size_t firstRecord = 0;
+        size_t recordCount = 0;
+        size_t writeOffset = 0; // Where the next record goes, right after the newest one
+        size_t usedBytes = 0;
+
+        GameSnapshot newest; // Decoded newest snapshot, the others are rebuilt from it
+        vector<uint8_t> delta;
+
+        void dropOldest();
+
+    public:
+        RewindBuffer(size_t capacity, size_t maxSnapshots);
+        void push(const GameSnapshot& snapshot);
+        bool rewind(GameSnapshot& snapshot);
+        void clear();
+        size_t getSnapshotCount() const;
+        size_t getUsedBytes() const;
+        size_t getMemoryBudget() const;
+};
+
+#endif
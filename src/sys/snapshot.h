@@ -0,0 +1,23 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <type_traits>
+#include "../entities/player.h"
+
+/**
+ * Everything the simulation needs to go back to a previous tick, the level itself never changes
+ * Map entities are left out: their animation is only drawn and which ones the player touches follows from his position,
+ * so snapshots keep the same size whatever the number of entities
+ * Plain data: copied with memcpy, and diffed byte by byte by the rewind buffer
+ */
+struct GameSnapshot {
+    PlayerSnapshot player;
+    uint64_t clockTicks;
+    bool clockRunning;
+    bool gameFinished;
+};
+
+static_assert(is_trivially_copyable_v<GameSnapshot>, "Snapshots are copied as raw bytes");
+
+#endif
@@ -0,0 +1,143 @@
+#include "spriteBatch.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Append the 2 triangles of a quad, corners are top left, top right, bottom left, bottom right
+ */
+void SpriteBatch::stage(const Texture& texture, uint8_t layer, const Vector2f corners[4], FloatRect textureRect, Color color) {
+    Vector2f textureEnd = textureRect.position + textureRect.size;
+    Vertex topLeft = {corners[0], color, textureRect.position};
+    Vertex topRight = {corners[1], color, {textureEnd.x, textureRect.position.y}};
+    Vertex bottomLeft = {corners[2], color, {textureRect.position.x, textureEnd.y}};
+    Vertex bottomRight = {corners[3], color, textureEnd};
+
+    quads.push_back({&texture, layer, (uint32_t) staged.size()});
+    staged.push_back(topLeft);
+    staged.push_back(topRight);
+    staged.push_back(bottomLeft);
+    staged.push_back(bottomLeft);
+    staged.push_back(topRight);
+    staged.push_back(bottomRight);
+}
+
+/**
+ * Add a sprite as it would be drawn with the given transform
+ */
+void SpriteBatch::add(const Sprite& sprite, uint8_t layer, const Transform& transform) {
+    FloatRect textureRect = FloatRect(sprite.getTextureRect());
+    Vector2f size = {abs(textureRect.size.x), abs(textureRect.size.y)};
+    Transform combined = transform * sprite.getTransform();
+    Vector2f corners[4] = {
+        combined.transformPoint({0, 0}),
+        combined.transformPoint({size.x, 0}),
+        combined.transformPoint({0, size.y}),
+        combined.transformPoint(size)
+    };
+    stage(sprite.getTexture(), layer, corners, textureRect, sprite.getColor());
+}
+
+/**
+ * Add an unscaled and unrotated rectangle of a texture, cheaper than going through a Sprite
+ */
+void SpriteBatch::add(const Texture& texture, IntRect textureRect, Vector2f position, uint8_t layer) {
+    Vector2f end = position + Vector2f(textureRect.size);
+    Vector2f corners[4] = {position, {end.x, position.y}, {position.x, end.y}, end};
+    stage(texture, layer, corners, FloatRect(textureRect), Color::White);
+}
+
+/**
+ * Run of the layer and texture of a quad, there are only a few so they are searched starting from the last one found
+ */
+SpriteBatch::Run& SpriteBatch::findRun(const Quad& quad, size_t& hint) {
+    if (hint < runs.size() && runs[hint].texture == quad.texture && runs[hint].layer == quad.layer) {
+        return runs[hint];
+    }
+    for (hint = 0; hint < runs.size(); hint++) {
+        if (runs[hint].texture == quad.texture && runs[hint].layer == quad.layer) {
+            return runs[hint];
+        }
+    }
+    runs.push_back({quad.texture, quad.layer, 0, 0, 0});
+    return runs.back();
+}
+
+/**
+ * Group the quads by layer and texture, returns the number of draw calls they take
+ * Counting the vertices of each group then copying them in place is linear, unlike sorting the quads
+ */
+size_t SpriteBatch::build() {
+    runs.clear();
+    size_t hint = 0;
+    for (const Quad& quad : quads) {
+        findRun(quad, hint).vertexCount += 6;
+    }
+    // Runs are created in the order of their first quad, a stable insertion sort on the layer keeps that order
+    // within a layer (there are only a few runs, and unlike stable_sort it does not allocate)
+    for (size_t i = 1; i < runs.size(); i++) {
+        Run run = runs[i];
+        size_t j = i;
+        for (; j > 0 && runs[j - 1].layer > run.layer; j--) {
+            runs[j] = runs[j - 1];
+        }
+        runs[j] = run;
+    }
+    size_t vertexCount = 0;
+    for (Run& run : runs) {
+        run.firstVertex = vertexCount;
+        vertexCount += run.vertexCount;
+    }
+
+    vertices.resize(vertexCount);
+    for (const Quad& quad : quads) {
+        Run& run = findRun(quad, hint);
+        copy(staged.begin() + quad.firstVertex, staged.begin() + quad.firstVertex + 6, vertices.begin() + run.firstVertex + run.filled);
+        run.filled += 6;
+    }
+
+    // Runs of different layers next to each other can share a draw when they have the same texture
+    size_t merged = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (merged > 0 && runs[merged - 1].texture == runs[i].texture) {
+            runs[merged - 1].vertexCount += runs[i].vertexCount;
+        } else {
+            runs[merged++] = runs[i];
+        }
+    }
+    runs.resize(merged);
+    return runs.size();
+}
+
+/**
+ * Draw every quad added since the last draw, one call per run of the same texture, then start a new frame
+ */
+void SpriteBatch::draw(RenderTarget& target, RenderStates states) {
+    build();
+    for (const Run& run : runs) {
+        states.texture = run.texture;
+        target.draw(vertices.data() + run.firstVertex, run.vertexCount, PrimitiveType::Triangles, states);
+    }
+    drawnSprites = quads.size();
+    drawCalls = runs.size();
+    clear();
+}
+
+void SpriteBatch::clear() {
+    quads.clear();
+    staged.clear();
+}
+
+/**
+ * Sprites added since the last draw
+ */
+size_t SpriteBatch::getSpriteCount() const {
+    return quads.size();
+}
+
+size_t SpriteBatch::getDrawnSprites() const {
+    return drawnSprites;
+}
+
+size_t SpriteBatch::getDrawCalls() const {
+    return drawCalls;
+}
\ No newline at end of file
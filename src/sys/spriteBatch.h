@@ -0,0 +1,63 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+using namespace sf;
+
+/**
+ * Layers of the sprites drawn over the level, lower layers are drawn first
+ */
+enum SpriteLayer : uint8_t {
+    LAYER_PLAYER,
+    LAYER_ENTITIES
+};
+
+/**
+ * Textured quads gathered during a frame and drawn together
+ * Quads are grouped by layer then by texture, consecutive groups with the same texture are drawn in one call,
+ * so everything from the texture atlas is a single draw. Within a layer, textures are drawn in the order their first quad
+ * was added and quads of a group keep the order they were added in
+ * The buffers are kept from frame to frame, a frame with no more sprites than the previous ones allocates nothing
+ */
+class SpriteBatch {
+    private:
+        struct Quad {
+            const Texture* texture;
+            uint8_t layer;
+            uint32_t firstVertex; // In the staged vertices
+        };
+
+        struct Run {
+            const Texture* texture;
+            uint8_t layer;
+            size_t firstVertex;
+            size_t vertexCount;
+            size_t filled; // Vertices copied so far while building
+        };
+
+        vector<Quad> quads;
+        vector<Vertex> staged; // 6 vertices per quad, in the order the quads were added
+        vector<Vertex> vertices; // Same vertices sorted by layer and texture
+        vector<Run> runs;
+        size_t drawnSprites = 0;
+        size_t drawCalls = 0;
+
+        void stage(const Texture& texture, uint8_t layer, const Vector2f corners[4], FloatRect textureRect, Color color);
+        Run& findRun(const Quad& quad, size_t& hint);
+
+    public:
+        void add(const Sprite& sprite, uint8_t layer, const Transform& transform = Transform::Identity);
+        void add(const Texture& texture, IntRect textureRect, Vector2f position, uint8_t layer);
+        size_t build();
+        void draw(RenderTarget& target, RenderStates states = RenderStates::Default);
+        void clear();
+        size_t getSpriteCount() const;
+        size_t getDrawnSprites() const;
+        size_t getDrawCalls() const;
+};
+
+#endif
\ No newline at end of file
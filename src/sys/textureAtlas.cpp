@@ -0,0 +1,129 @@
+#include "textureAtlas.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+vector<Vector2u> packRectangles(const vector<Vector2u>& sizes, unsigned int width, unsigned int padding, unsigned int& height) {
+    vector<size_t> order(sizes.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a].y > sizes[b].y; });
+
+    vector<Vector2u> positions(sizes.size());
+    Vector2u cursor = {0, 0};
+    unsigned int rowHeight = 0;
+    for (size_t index : order) {
+        if (cursor.x > 0 && cursor.x + sizes[index].x > width) {
+            cursor = {0, cursor.y + rowHeight + padding};
+            rowHeight = 0;
+        }
+        positions[index] = cursor;
+        cursor.x += sizes[index].x + padding;
+        rowHeight = max(rowHeight, sizes[index].y);
+    }
+    height = cursor.y + rowHeight;
+    return positions;
+}
+
+unsigned int nextPowerOfTwo(unsigned int value) {
+    unsigned int power = 1;
+    while (power < value) {
+        power *= 2;
+    }
+    return power;
+}
+
+Vector2u packAtlas(const vector<Vector2u>& sizes, unsigned int maxSize, vector<Vector2u>& positions) {
+    unsigned int widest = 0;
+    for (Vector2u size : sizes) {
+        widest = max(widest, size.x);
+    }
+
+    // Try every power of two width and keep the one wasting the least space
+    Vector2u best = {0, 0};
+    for (unsigned int width = max(nextPowerOfTwo(widest), (unsigned int) ATLAS_MIN_WIDTH); width <= maxSize; width *= 2) {
+        unsigned int height;
+        vector<Vector2u> candidate = packRectangles(sizes, width, ATLAS_PADDING, height);
+        height = nextPowerOfTwo(max(height, 1u));
+        if (height > maxSize) {
+            continue;
+        }
+        if (best.x == 0 || (size_t) width * height < (size_t) best.x * best.y) {
+            best = {width, height};
+            positions = candidate;
+        }
+    }
+    if (best.x == 0) {
+        throw runtime_error("Texture atlas does not fit in a texture");
+    }
+    return best;
+}
+
+void TextureAtlas::add(AtlasRegion region, AssetHandle image) {
+    sources.push_back({region, image});
+}
+
+/**
+ * Pack the added images into one texture and upload it, the atlas stops holding the source images
+ */
+void TextureAtlas::pack() {
+    vector<Vector2u> sizes;
+    for (const Source& source : sources) {
+        sizes.push_back(source.image.getImage().getSize());
+    }
+    vector<Vector2u> positions;
+    size = packAtlas(sizes, Texture::getMaximumSize(), positions);
+
+    Image image(size, Color::Transparent);
+    usedPixels = 0;
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!image.copy(sources[i].image.getImage(), positions[i])) {
+            throw runtime_error("Failed to copy " + sources[i].image.getPath() + " into the texture atlas");
+        }
+        regions[(int) sources[i].region] = IntRect(Vector2i(positions[i]), Vector2i(sizes[i]));
+        usedPixels += (size_t) sizes[i].x * sizes[i].y;
+    }
+    if (!texture.loadFromImage(image)) {
+        throw runtime_error("Failed to upload the texture atlas");
+    }
+    sources.clear();
+
+    Vector2i tileset = regions[(int) AtlasRegion::TILESET].position;
+    tileOrigins.resize(TILESET_TILE_COUNT);
+    for (int tileType = 0; tileType < TILESET_TILE_COUNT; tileType++) {
+        tileOrigins[tileType] = Vector2f(tileset.x + (tileType % TILESET_COLUMNS) * TILE_SIZE.x, tileset.y + (tileType / TILESET_COLUMNS) * TILE_SIZE.y);
+    }
+
+    if (DEBUG) {
+        cout << "Texture atlas: " << size.x << "x" << size.y << ", " << (int) (getFillRatio() * 100) << "% used" << endl;
+    }
+}
+
+const Texture& TextureAtlas::getTexture() const {
+    return texture;
+}
+
+Vector2u TextureAtlas::getSize() const {
+    return size;
+}
+
+float TextureAtlas::getFillRatio() const {
+    return size.x == 0 ? 0.0f : (float) usedPixels / ((size_t) size.x * size.y);
+}
+
+IntRect TextureAtlas::getRegion(AtlasRegion region) const {
+    return regions[(int) region];
+}
+
+/**
+ * Rectangle of a source image in atlas coordinates
+ */
+IntRect TextureAtlas::map(AtlasRegion region, IntRect rect) const {
+    return IntRect(regions[(int) region].position + rect.position, rect.size);
+}
+
+/**
+ * Texture position of every tile type, index is the tile type
+ */
+const vector<Vector2f>& TextureAtlas::getTileOrigins() const {
+    return tileOrigins;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "assetCache.h"
+#include "../util/globalConstants.h"
+
+using namespace std;
+using namespace sf;
+
+#define ATLAS_PADDING 2 // Transparent pixels between two images so filtering never samples a neighbour
+#define ATLAS_MIN_WIDTH 256
+
+enum class AtlasRegion : uint8_t { TILESET, BACKGROUND, PLAYER, TUTORIAL_ARROW, SACRED_FRUIT, COUNT };
+
+/**
+ * Place rectangles of the given sizes in rows of a width wide area, tallest first
+ * Returns the position of each rectangle and the height used
+ */
+vector<Vector2u> packRectangles(const vector<Vector2u>& sizes, unsigned int width, unsigned int padding, unsigned int& height);
+
+/**
+ * Pack rectangles into the power of two area wasting the least space, throws if a side would be over maxSize
+ * Returns the size of the area, positions receives the position of each rectangle
+ * maxSize is the largest texture the GPU supports, passed in so that packing does not need a graphics context
+ */
+Vector2u packAtlas(const vector<Vector2u>& sizes, unsigned int maxSize, vector<Vector2u>& positions);
+
+/**
+ * Every image of the world in a single texture, so the level, the player and the entities are drawn with one texture binding
+ * Images are added by region then packed once, rectangles of the source images are looked up in atlas coordinates
+ */
+class TextureAtlas {
+    private:
+        struct Source {
+            AtlasRegion region;
+            AssetHandle image;
+        };
+
+        vector<Source> sources;
+        Texture texture;
+        Vector2u size;
+        IntRect regions[(int) AtlasRegion::COUNT];
+        vector<Vector2f> tileOrigins; // Top left corner of every tile type of the tileset
+        size_t usedPixels = 0;
+
+    public:
+        void add(AtlasRegion region, AssetHandle image);
+        void pack();
+        const Texture& getTexture() const;
+        Vector2u getSize() const;
+        float getFillRatio() const;
+        IntRect getRegion(AtlasRegion region) const;
+        IntRect map(AtlasRegion region, IntRect rect) const;
+        const vector<Vector2f>& getTileOrigins() const;
+};
+
+#endif
\ No newline at end of file
@@ -2,33 +2,14 @@
 #define TILE_H
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include "../util/globalConstants.h"
-#include "../util/collisionTable.h"
+#include "../util/tileMetadata.h"
 #include <iostream>
 
 using namespace std;
 
-class Tile {
-private:
-    RectangleShape hitbox;
+Vector2f getTileOrigin(int x, int y);
+FloatRect getTileHitbox(int x, int y, int tileType);
 
-    int x;
-    int y;
-    int tileType;
-    bool solid;
-    bool dangerous;
-
-public:
-    Tile(int x, int y, int tileType);
-    Tile();
-    void setX(int x);
-    void setY(int y);
-    int getX() const;
-    int getY() const;
-    int getTileType() const;
-    bool isSolid() const;
-    bool isDangerous() const;
-    sf::RectangleShape& getHitbox();
-};
-
-#endif
\ No newline at end of file
+#endif
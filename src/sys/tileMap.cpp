@@ -0,0 +1,127 @@
+#include "tileMap.h"
+#include <algorithm>
+
+void TileChunk::computeFlags() {
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        solidRows[y] = 0;
+        dangerousRows[y] = 0;
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            uint8_t tileFlags = getTileInfo(tileTypes[x + y * CHUNK_SIZE]).flags;
+            flags[x + y * CHUNK_SIZE] = tileFlags;
+            solidRows[y] |= (uint32_t) ((tileFlags & TILE_SOLID) != 0) << x;
+            dangerousRows[y] |= (uint32_t) ((tileFlags & TILE_DANGEROUS) != 0) << x;
+        }
+    }
+}
+
+TileMap::TileMap() : size({0, 0}), chunkCount({0, 0}) {}
+
+/**
+ * Empty map, chunks are added later with setChunk
+ */
+TileMap::TileMap(Vector2u size) : size(size) {
+    chunkCount = ::getChunkCount(size);
+    chunks.resize(chunkCount.x * chunkCount.y);
+    residentChunks.reserve(chunks.size());
+}
+
+/**
+ * Fully resident map built from two row-major layers
+ */
+TileMap::TileMap(Vector2u size, const int16_t* mainLayer, const int16_t* backgroundLayer, ObjectPool<TileChunk>& chunkPool) : TileMap(size) {
+    for (unsigned int chunkY = 0; chunkY < chunkCount.y; chunkY++) {
+        for (unsigned int chunkX = 0; chunkX < chunkCount.x; chunkX++) {
+            ChunkPointer chunk = chunkPool.acquire();
+            for (unsigned int y = 0; y < CHUNK_SIZE; y++) {
+                for (unsigned int x = 0; x < CHUNK_SIZE; x++) {
+                    unsigned int levelX = chunkX * CHUNK_SIZE + x;
+                    unsigned int levelY = chunkY * CHUNK_SIZE + y;
+                    bool inside = levelX < size.x && levelY < size.y;
+                    chunk->tileTypes[x + y * CHUNK_SIZE] = inside ? mainLayer[levelX + levelY * size.x] : -1;
+                    chunk->backgroundTileTypes[x + y * CHUNK_SIZE] = inside ? backgroundLayer[levelX + levelY * size.x] : -1;
+                }
+            }
+            chunk->computeFlags();
+            setChunk(chunkX + chunkY * chunkCount.x, move(chunk));
+        }
+    }
+}
+
+Vector2u TileMap::getSize() const {
+    return size;
+}
+
+Vector2u TileMap::getChunkCount() const {
+    return chunkCount;
+}
+
+bool TileMap::contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < (int) size.x && y < (int) size.y;
+}
+
+const TileChunk* TileMap::getChunkAt(int x, int y) const {
+    return chunks[x / CHUNK_SIZE + (y / CHUNK_SIZE) * chunkCount.x].get();
+}
+
+int TileMap::getTileType(int x, int y) const {
+    const TileChunk* chunk = getChunkAt(x, y);
+    return chunk != nullptr ? chunk->tileTypes[x % CHUNK_SIZE + (y % CHUNK_SIZE) * CHUNK_SIZE] : -1;
+}
+
+uint8_t TileMap::getFlags(int x, int y) const {
+    const TileChunk* chunk = getChunkAt(x, y);
+    return chunk != nullptr ? chunk->flags[x % CHUNK_SIZE + (y % CHUNK_SIZE) * CHUNK_SIZE] : TILE_UNLOADED_FLAGS;
+}
+
+bool TileMap::isSolid(int x, int y) const {
+    return getFlags(x, y) & TILE_SOLID;
+}
+
+bool TileMap::isDangerous(int x, int y) const {
+    return getFlags(x, y) & TILE_DANGEROUS;
+}
+
+FloatRect TileMap::getHitbox(int x, int y) const {
+    return getTileHitbox(x, y, getTileType(x, y));
+}
+
+void TileMap::setChunk(int index, ChunkPointer chunk) {
+    if (chunks[index] == nullptr) {
+        residentChunks.push_back(index);
+    }
+    chunks[index] = move(chunk);
+}
+
+void TileMap::releaseChunk(int index) {
+    if (chunks[index] != nullptr) {
+        chunks[index].reset();
+        residentChunks.erase(find(residentChunks.begin(), residentChunks.end(), index));
+    }
+}
+
+bool TileMap::isChunkResident(int index) const {
+    return chunks[index] != nullptr;
+}
+
+TileChunk* TileMap::getChunk(int index) {
+    return chunks[index].get();
+}
+
+const TileChunk* TileMap::getChunk(int index) const {
+    return chunks[index].get();
+}
+
+const vector<int>& TileMap::getResidentChunks() const {
+    return residentChunks;
+}
+
+/**
+ * Occupancy bits of a chunk wide row, unloaded chunks are all solid
+ */
+uint32_t TileMap::getRowBits(int chunkX, int y, TileFlag property) const {
+    const TileChunk* chunk = chunks[chunkX + (y / CHUNK_SIZE) * chunkCount.x].get();
+    if (chunk == nullptr) {
+        return property == TILE_SOLID ? ~0u : 0;
+    }
+    return property == TILE_SOLID ? chunk->solidRows[y % CHUNK_SIZE] : chunk->dangerousRows[y % CHUNK_SIZE];
+}
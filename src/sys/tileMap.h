@@ -0,0 +1,110 @@
+#ifndef TILE_MAP_H
+#define TILE_MAP_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "tile.h"
+#include "levelFile.h"
+#include "../util/bits.h"
+#include "../util/objectPool.h"
+
+using namespace std;
+using namespace sf;
+
+// Flags returned for tiles of chunks that are not loaded yet, they behave like walls
+#define TILE_UNLOADED_FLAGS (TILE_SOLID | TILE_UNLOADED)
+
+/**
+ * Square block of CHUNK_SIZE * CHUNK_SIZE tiles, the unit in which levels are loaded and evicted
+ */
+struct TileChunk {
+    int16_t tileTypes[CHUNK_SIZE * CHUNK_SIZE];
+    int16_t backgroundTileTypes[CHUNK_SIZE * CHUNK_SIZE];
+    uint8_t flags[CHUNK_SIZE * CHUNK_SIZE];
+
+    // One bit per tile, bit x of row y is set when the tile at (x, y) has the property
+    uint32_t solidRows[CHUNK_SIZE];
+    uint32_t dangerousRows[CHUNK_SIZE];
+
+    // Tile geometry uploaded once when the chunk is installed
+    VertexBuffer mainLayerBuffer = VertexBuffer(PrimitiveType::Triangles, VertexBuffer::Usage::Static);
+    VertexBuffer backgroundLayerBuffer = VertexBuffer(PrimitiveType::Triangles, VertexBuffer::Usage::Static);
+
+    // Only kept when vertex buffers are not supported by the graphics driver
+    vector<Vertex> mainLayerVertices;
+    vector<Vertex> backgroundLayerVertices;
+
+    void computeFlags();
+};
+
+typedef ObjectPool<TileChunk>::Pointer ChunkPointer; // Chunks come from the chunk pool of their level
+
+/**
+ * Chunked tile storage, each chunk keeps its tile types and flags in row-major arrays
+ * Chunks can be missing when the level is streamed, hitboxes are computed on demand
+ */
+class TileMap {
+    private:
+        Vector2u size;
+        Vector2u chunkCount;
+        vector<ChunkPointer> chunks;
+        vector<int> residentChunks;
+
+        const TileChunk* getChunkAt(int x, int y) const;
+
+    public:
+        TileMap();
+        TileMap(Vector2u size);
+        TileMap(Vector2u size, const int16_t* mainLayer, const int16_t* backgroundLayer, ObjectPool<TileChunk>& chunkPool);
+        Vector2u getSize() const;
+        Vector2u getChunkCount() const;
+        bool contains(int x, int y) const;
+        int getTileType(int x, int y) const;
+        uint8_t getFlags(int x, int y) const;
+        bool isSolid(int x, int y) const;
+        bool isDangerous(int x, int y) const;
+        FloatRect getHitbox(int x, int y) const;
+
+        void setChunk(int index, ChunkPointer chunk);
+        void releaseChunk(int index);
+        bool isChunkResident(int index) const;
+        TileChunk* getChunk(int index);
+        const TileChunk* getChunk(int index) const;
+        const vector<int>& getResidentChunks() const;
+
+        uint32_t getRowBits(int chunkX, int y, TileFlag property) const;
+        template <typename Callback> bool findTiles(IntRect range, TileFlag property, Callback callback) const;
+};
+
+/**
+ * Call callback(x, y) for every tile of a range of tiles having a property (TILE_SOLID or TILE_DANGEROUS)
+ * Rows are scanned one chunk wide word at a time, only the set bits are visited
+ * Stops and returns true as soon as the callback returns true
+ */
+template <typename Callback> bool TileMap::findTiles(IntRect range, TileFlag property, Callback callback) const {
+    int startX = max(0, range.position.x);
+    int startY = max(0, range.position.y);
+    int endX = min((int) size.x - 1, range.position.x + range.size.x - 1);
+    int endY = min((int) size.y - 1, range.position.y + range.size.y - 1);
+
+    for (int y = startY; y <= endY; y++) {
+        for (int chunkX = startX / CHUNK_SIZE; chunkX <= endX / CHUNK_SIZE; chunkX++) {
+            int first = max(startX - chunkX * CHUNK_SIZE, 0);
+            int last = min(endX - chunkX * CHUNK_SIZE, CHUNK_SIZE - 1);
+            uint32_t bits = getRowBits(chunkX, y, property) & bitRange(first, last);
+            while (bits != 0) {
+                int x = chunkX * CHUNK_SIZE + countTrailingZeros(bits);
+                if (callback(x, y)) {
+                    return true;
+                }
+                bits &= bits - 1;
+            }
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include "tileMask.h"
+#include "../util/bits.h"
+#include "../util/tileMetadata.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * Pixels of a tile covered by a box, as a range of columns and rows clamped to the tile
+ * Returns false when the box does not cover any pixel of the tile
+ */
+static bool getPixelRange(Vector2f origin, FloatRect box, int& startX, int& endX, int& startY, int& endY) {
+    startX = max(0, (int) floor(box.position.x - origin.x));
+    startY = max(0, (int) floor(box.position.y - origin.y));
+    endX = min((int) TILE_SIZE.x - 1, (int) ceil(box.position.x + box.size.x - origin.x) - 1);
+    endY = min((int) TILE_SIZE.y - 1, (int) ceil(box.position.y + box.size.y - origin.y) - 1);
+    return startX <= endX && startY <= endY;
+}
+
+/**
+ * Check if a box in pixels overlaps a solid pixel of the tile whose top left corner is at origin
+ */
+bool TileMask::overlaps(Vector2f origin, FloatRect box) const {
+    int startX, endX, startY, endY;
+    if (!getPixelRange(origin, box, startX, endX, startY, endY)) {
+        return false;
+    }
+    uint32_t columns = bitRange(startX, endX);
+    for (int y = startY; y <= endY; y++) {
+        if (rows[y] & columns) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Extent along an axis of the solid pixels lying in the band the box covers on the other axis
+ * e.g. for the 'y' axis, start is the top of the highest solid pixel in the columns of the box
+ * Returns false when that band of the tile is empty
+ */
+bool TileMask::getExtent(Vector2f origin, FloatRect box, char axis, float& start, float& end) const {
+    int startX, endX, startY, endY;
+    if (axis == 'x') {
+        box = FloatRect({origin.x, box.position.y}, {(float) TILE_SIZE.x, box.size.y});
+    } else {
+        box = FloatRect({box.position.x, origin.y}, {box.size.x, (float) TILE_SIZE.y});
+    }
+    if (!getPixelRange(origin, box, startX, endX, startY, endY)) {
+        return false;
+    }
+
+    uint32_t bits = 0;
+    if (axis == 'x') {
+        for (int y = startY; y <= endY; y++) {
+            bits |= rows[y];
+        }
+        if (bits == 0) {
+            return false;
+        }
+        start = origin.x + countTrailingZeros(bits);
+        end = origin.x + highestBit(bits) + 1;
+        return true;
+    }
+
+    uint32_t columns = bitRange(startX, endX);
+    int first = -1;
+    int last = -1;
+    for (int y = 0; y < (int) TILE_SIZE.y; y++) {
+        if (rows[y] & columns) {
+            first = first < 0 ? y : first;
+            last = y;
+        }
+    }
+    if (first < 0) {
+        return false;
+    }
+    start = origin.y + first;
+    end = origin.y + last + 1;
+    return true;
+}
+
+TileMaskSet::TileMaskSet() {
+    masks = vector<TileMask>(TILESET_TILE_COUNT + 1);
+}
+
+/**
+ * Derive the mask of every tile from the alpha channel of the tileset, then apply the override files
+ */
+TileMaskSet::TileMaskSet(const Image& tileset, string overrideDirectory) {
+    masks = vector<TileMask>(TILESET_TILE_COUNT + 1);
+
+    for (int tileType = 0; tileType < TILESET_TILE_COUNT; tileType++) {
+        Vector2u origin = {(tileType % TILESET_COLUMNS) * TILE_SIZE.x, (tileType / TILESET_COLUMNS) * TILE_SIZE.y};
+        if (origin.x + TILE_SIZE.x > tileset.getSize().x || origin.y + TILE_SIZE.y > tileset.getSize().y) {
+            continue;
+        }
+
+        // Pixels cut by the insets of the tile metadata stay empty (e.g. the top of spikes)
+        const TileInfo& info = getTileInfo(tileType);
+        TileMask& mask = masks[tileType + 1];
+        for (unsigned int y = info.insetTop; y < TILE_SIZE.y - info.insetBottom; y++) {
+            for (unsigned int x = info.insetLeft; x < TILE_SIZE.x - info.insetRight; x++) {
+                if (tileset.getPixel(origin + Vector2u(x, y)).a >= 128) {
+                    mask.rows[y] |= 1 << x;
+                }
+            }
+        }
+    }
+
+    if (!filesystem::is_directory(overrideDirectory)) {
+        return;
+    }
+    for (const auto& entry : filesystem::directory_iterator(overrideDirectory)) {
+        if (entry.path().extension() != TILE_MASK_EXTENSION) {
+            continue;
+        }
+        string name = entry.path().stem().string();
+        if (name.empty() || name.find_first_not_of("0123456789") != string::npos || stoi(name) >= TILESET_TILE_COUNT) {
+            throw runtime_error("Invalid tile mask file name " + entry.path().string());
+        }
+        loadOverride(stoi(name), entry.path().string());
+    }
+}
+
+/**
+ * Read a mask drawn as 16 lines of 16 characters, '#' for solid pixels and '.' for empty ones
+ */
+void TileMaskSet::loadOverride(int tileType, string filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open " + filename);
+    }
+
+    TileMask mask;
+    string line;
+    for (unsigned int y = 0; y < TILE_SIZE.y; y++) {
+        if (!getline(file, line) || line.size() < TILE_SIZE.x || line.find_first_not_of("#.") < TILE_SIZE.x) {
+            throw runtime_error("Malformed tile mask " + filename);
+        }
+        for (unsigned int x = 0; x < TILE_SIZE.x; x++) {
+            if (line[x] == '#') {
+                mask.rows[y] |= 1 << x;
+            }
+        }
+    }
+    masks[tileType + 1] = mask;
+}
+
+const TileMask& TileMaskSet::getMask(int tileType) const {
+    if (tileType < -1 || tileType >= TILESET_TILE_COUNT) {
+        return masks[0];
+    }
+    return masks[tileType + 1];
+}
@@ -0,0 +1,49 @@
+#ifndef TILE_MASK_H
+#define TILE_MASK_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../util/globalConstants.h"
+
+#define TILE_MASK_DIRECTORY "assets/tiles/masks/"
+#define TILE_MASK_EXTENSION ".mask"
+
+using namespace std;
+using namespace sf;
+
+static_assert(TILE_SIZE.x == 16 && TILE_SIZE.y == 16, "Tile masks store one 16 bit word per row");
+
+/**
+ * Solid pixels of a tile, one word per row of pixels, bit x is the column x
+ */
+struct TileMask {
+    array<uint16_t, 16> rows = {};
+
+    bool overlaps(Vector2f origin, FloatRect box) const;
+    bool getExtent(Vector2f origin, FloatRect box, char axis, float& start, float& end) const;
+};
+
+inline constexpr TileMask FULL_TILE_MASK = {{0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF}};
+
+/**
+ * Collision masks of every tile of the tileset
+ * Built from the alpha of the tileset clipped to the hitbox insets of each tile, 
+ * a <tile type>.mask file in the override directory replaces the mask of that tile
+ */
+class TileMaskSet {
+    private:
+        vector<TileMask> masks; // Index 0 is used for empty cells (-1), tile type t is at index t + 1
+
+        void loadOverride(int tileType, string filename);
+
+    public:
+        TileMaskSet();
+        TileMaskSet(const Image& tileset, string overrideDirectory);
+        const TileMask& getMask(int tileType) const;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "tileMesh.h"
+
+TileMeshBuilder::TileMeshBuilder() {}
+
+/**
+ * Look at the pixels of every tile of the tileset once to classify them
+ */
+TileMeshBuilder::TileMeshBuilder(const Image& tileset) {
+    appearances = vector<TileAppearance>(TILESET_TILE_COUNT, TileAppearance::DETAILED);
+    tileOrigins = vector<Vector2f>(TILESET_TILE_COUNT);
+
+    for (int tileType = 0; tileType < TILESET_TILE_COUNT; tileType++) {
+        Vector2u origin = {(tileType % TILESET_COLUMNS) * TILE_SIZE.x, (tileType / TILESET_COLUMNS) * TILE_SIZE.y};
+        tileOrigins[tileType] = Vector2f(origin);
+        if (origin.x + TILE_SIZE.x > tileset.getSize().x || origin.y + TILE_SIZE.y > tileset.getSize().y) {
+            appearances[tileType] = TileAppearance::EMPTY;
+            continue;
+        }
+
+        Color first = tileset.getPixel(origin);
+        bool transparent = true;
+        bool uniform = first.a == 255;
+        for (unsigned int y = 0; y < TILE_SIZE.y; y++) {
+            for (unsigned int x = 0; x < TILE_SIZE.x; x++) {
+                Color pixel = tileset.getPixel(origin + Vector2u(x, y));
+                transparent = transparent && pixel.a == 0;
+                uniform = uniform && pixel == first;
+            }
+        }
+
+        if (transparent) {
+            appearances[tileType] = TileAppearance::EMPTY;
+        } else if (uniform) {
+            appearances[tileType] = TileAppearance::UNIFORM;
+        }
+    }
+}
+
+TileAppearance TileMeshBuilder::getAppearance(int tileType) const {
+    if (tileType < 0 || tileType >= (int) appearances.size()) {
+        return TileAppearance::EMPTY;
+    }
+    return appearances[tileType];
+}
+
+/**
+ * Sample the tiles somewhere else than in the tileset image, like the texture atlas, index is the tile type
+ */
+void TileMeshBuilder::setTileOrigins(const vector<Vector2f>& origins) {
+    tileOrigins = origins;
+}
+
+void TileMeshBuilder::appendQuad(vector<Vertex>& vertices, Vector2f position, Vector2f size, Vector2f texturePosition, Vector2f textureSize) const {
+    Vector2f end = position + size;
+    Vector2f textureEnd = texturePosition + textureSize;
+
+    vertices.push_back({position, Color::White, texturePosition});
+    vertices.push_back({{end.x, position.y}, Color::White, {textureEnd.x, texturePosition.y}});
+    vertices.push_back({{position.x, end.y}, Color::White, {texturePosition.x, textureEnd.y}});
+    vertices.push_back({{position.x, end.y}, Color::White, {texturePosition.x, textureEnd.y}});
+    vertices.push_back({{end.x, position.y}, Color::White, {textureEnd.x, texturePosition.y}});
+    vertices.push_back({end, Color::White, textureEnd});
+}
+
+/**
+ * Append 2 triangles per visible cell or per run of uniform cells
+ * layer points to the first cell, rows are stride cells apart, origin is the grid position of that first cell
+ */
+void TileMeshBuilder::build(vector<Vertex>& vertices, const int16_t* layer, int stride, Vector2u origin, Vector2u tileCount) const {
+    vertices.clear();
+
+    for (unsigned int y = 0; y < tileCount.y; y++) {
+        const int16_t* row = layer + y * stride;
+        unsigned int x = 0;
+        while (x < tileCount.x) {
+            int tileType = row[x];
+            TileAppearance appearance = getAppearance(tileType);
+            if (appearance == TileAppearance::EMPTY) {
+                x++;
+                continue;
+            }
+
+            Vector2f texturePosition = tileOrigins[tileType];
+            Vector2f position = {(float) (origin.x + x) * TILE_SIZE.x, (float) (origin.y + y) * TILE_SIZE.y};
+
+            if (appearance == TileAppearance::UNIFORM) {
+                unsigned int runLength = 1;
+                while (x + runLength < tileCount.x && row[x + runLength] == tileType) {
+                    runLength++;
+                }
+                // Every texel of the tile has the same color, sample its center over the whole run
+                Vector2f center = texturePosition + Vector2f(TILE_SIZE) / 2.0f;
+                appendQuad(vertices, position, {(float) runLength * TILE_SIZE.x, (float) TILE_SIZE.y}, center, {0, 0});
+                x += runLength;
+            } else {
+                appendQuad(vertices, position, Vector2f(TILE_SIZE), texturePosition, Vector2f(TILE_SIZE));
+                x++;
+            }
+        }
+    }
+}
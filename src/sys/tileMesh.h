@@ -0,0 +1,37 @@
+#ifndef TILE_MESH_H
+#define TILE_MESH_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "../util/globalConstants.h"
+
+using namespace std;
+using namespace sf;
+
+enum class TileAppearance : uint8_t {
+    EMPTY,    // Fully transparent, nothing to draw
+    UNIFORM,  // Every pixel has the same opaque color, can be stretched over several cells
+    DETAILED
+};
+
+/**
+ * Build the triangles of a layer of tiles, skipping empty cells and merging 
+ * horizontal runs of the same uniform tile into a single quad
+ */
+class TileMeshBuilder {
+    private:
+        vector<TileAppearance> appearances;
+        vector<Vector2f> tileOrigins; // Texture position of every tile type, in the tileset until moved into an atlas
+
+        void appendQuad(vector<Vertex>& vertices, Vector2f position, Vector2f size, Vector2f texturePosition, Vector2f textureSize) const;
+
+    public:
+        TileMeshBuilder();
+        TileMeshBuilder(const Image& tileset);
+        TileAppearance getAppearance(int tileType) const;
+        void setTileOrigins(const vector<Vector2f>& origins);
+        void build(vector<Vertex>& vertices, const int16_t* layer, int stride, Vector2u origin, Vector2u tileCount) const;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstring>
+
+Arena::Arena(size_t blockSize) : blockSize(blockSize) {}
+
+Arena::~Arena() {
+    reset();
+}
+
+Arena::Arena(Arena&& other) noexcept : blockSize(other.blockSize) {
+    *this = move(other);
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        reset();
+        blockSize = other.blockSize;
+        swap(current, other.current);
+        swap(offset, other.offset);
+        swap(destructors, other.destructors);
+        swap(blockCount, other.blockCount);
+        swap(usedBytes, other.usedBytes);
+    }
+    return *this;
+}
+
+/**
+ * Start a new block big enough for an allocation, the end of the previous one is left unused
+ */
+void Arena::addBlock(size_t minimumSize) {
+    size_t size = max(blockSize, minimumSize + sizeof(Block));
+    Block* block = (Block*) ::operator new(size);
+    block->previous = current;
+    block->size = size;
+    current = block;
+    offset = sizeof(Block);
+    blockCount++;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    size_t start = current == nullptr ? 0 : (offset + alignment - 1) & ~(alignment - 1);
+    if (current == nullptr || start + size > current->size) {
+        addBlock(size + alignment);
+        start = (offset + alignment - 1) & ~(alignment - 1);
+    }
+    offset = start + size;
+    usedBytes += size;
+    return (unsigned char*) current + start;
+}
+
+/**
+ * Copy a string into the arena, the copy is not null terminated
+ */
+string_view Arena::copyString(string_view text) {
+    char* copy = (char*) allocate(max<size_t>(text.size(), 1), 1);
+    memcpy(copy, text.data(), text.size());
+    return string_view(copy, text.size());
+}
+
+/**
+ * Destroy every object and free every block
+ */
+void Arena::reset() {
+    for (Destructor* destructor = destructors; destructor != nullptr; destructor = destructor->next) {
+        destructor->destroy(destructor->object);
+    }
+    destructors = nullptr;
+    while (current != nullptr) {
+        Block* previous = current->previous;
+        ::operator delete((void*) current);
+        current = previous;
+    }
+    offset = 0;
+    blockCount = 0;
+    usedBytes = 0;
+}
+
+size_t Arena::getBlockCount() const {
+    return blockCount;
+}
+
+size_t Arena::getUsedBytes() const {
+    return usedBytes;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+#define ARENA_BLOCK_SIZE (16 * 1024)
+
+/**
+ * Array of objects living in an arena, only iterated, the arena owns the memory
+ */
+template <typename T> struct ArenaArray {
+    T* data = nullptr;
+    size_t count = 0;
+
+    T* begin() const { return data; }
+    T* end() const { return data + count; }
+    size_t size() const { return count; }
+    T& operator[](size_t index) const { return data[index]; }
+};
+
+/**
+ * Bump allocator for everything that lives as long as a level, freed all at once by reset() instead of object by object
+ * Memory comes in blocks of ARENA_BLOCK_SIZE, bigger allocations get a block of their own
+ * Objects with a destructor are recorded and destroyed in reverse order on reset
+ * Not thread safe
+ */
+class Arena {
+    private:
+        struct Block {
+            Block* previous;
+            size_t size;
+        };
+
+        struct Destructor {
+            void (*destroy)(void*);
+            void* object;
+            Destructor* next;
+        };
+
+        size_t blockSize;
+        Block* current = nullptr;
+        size_t offset = 0; // Used bytes of the current block, header included
+        Destructor* destructors = nullptr;
+        size_t blockCount = 0;
+        size_t usedBytes = 0;
+
+        void addBlock(size_t minimumSize);
+
+    public:
+        Arena(size_t blockSize = ARENA_BLOCK_SIZE);
+        ~Arena();
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        Arena(Arena&& other) noexcept;
+        Arena& operator=(Arena&& other) noexcept;
+
+        void* allocate(size_t size, size_t alignment);
+        template <typename T, typename... Args> T* create(Args&&... args);
+        template <typename T> ArenaArray<T> createArray(size_t count);
+        string_view copyString(string_view text);
+        void reset();
+        size_t getBlockCount() const;
+        size_t getUsedBytes() const;
+};
+
+/**
+ * Construct an object in the arena, its destructor runs on reset
+ */
+template <typename T, typename... Args> T* Arena::create(Args&&... args) {
+    T* object = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+    if (!is_trivially_destructible<T>::value) {
+        Destructor* destructor = (Destructor*) allocate(sizeof(Destructor), alignof(Destructor));
+        *destructor = {[](void* pointer) { ((T*) pointer)->~T(); }, object, destructors};
+        destructors = destructor;
+    }
+    return object;
+}
+
+/**
+ * Default constructed array, only for types without a destructor so nothing has to be recorded per element
+ */
+template <typename T> ArenaArray<T> Arena::createArray(size_t count) {
+    static_assert(is_trivially_destructible<T>::value, "Arena arrays cannot hold objects with a destructor");
+    T* data = (T*) allocate(sizeof(T) * max<size_t>(count, 1), alignof(T));
+    for (size_t i = 0; i < count; i++) {
+        new (data + i) T();
+    }
+    return {data, count};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef BITS_H
+#define BITS_H
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit, value must not be 0
+inline int countTrailingZeros(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// Index of the highest set bit, value must not be 0
+inline int highestBit(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return index;
+#else
+    return 31 - __builtin_clz(value);
+#endif
+}
+
+inline int countBits(uint32_t value) {
+#ifdef _MSC_VER
+    return __popcnt(value);
+#else
+    return __builtin_popcount(value);
+#endif
+}
+
+// Bits first to last included set
+inline uint32_t bitRange(int first, int last) {
+    return (last >= 31 ? ~0u : (1u << (last + 1)) - 1) & ~((1u << first) - 1);
+}
+
+#endif
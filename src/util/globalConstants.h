@@ -10,8 +10,8 @@ using namespace sf;
 
 constexpr Vector2u SCREEN_RESOLUTION = {640, 360};
 constexpr Vector2u TILE_SIZE = {16, 16};
-
-const Font GAME_FONT("assets/fonts/VCR_OSD_MONO_1.001.ttf");
+constexpr int TILESET_COLUMNS = 25; // tiles.png is 25 * 25 tiles
+constexpr int TILESET_TILE_COUNT = TILESET_COLUMNS * TILESET_COLUMNS;
 
 #define MENU_INPUT_DELAY 0.4f
 
@@ -0,0 +1,80 @@
+#include "mappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(string filename) {
+    fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        throw runtime_error("Failed to open " + filename);
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    size = fileSize.QuadPart;
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        CloseHandle(fileHandle);
+        throw runtime_error("Failed to map " + filename);
+    }
+    data = (const unsigned char*) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw runtime_error("Failed to map " + filename);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != nullptr) CloseHandle(fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(string filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Failed to open " + filename);
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) < 0 || fileStat.st_size == 0) {
+        close(fd);
+        throw runtime_error("Failed to map " + filename);
+    }
+    size = fileStat.st_size;
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the file descriptor is closed
+    if (mapping == MAP_FAILED) {
+        throw runtime_error("Failed to map " + filename);
+    }
+    data = (const unsigned char*) mapping;
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) munmap((void*) data, size);
+}
+
+#endif
+
+const unsigned char* MappedFile::getData() const {
+    return data;
+}
+
+size_t MappedFile::getSize() const {
+    return size;
+}
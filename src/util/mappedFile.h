@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * Read-only memory mapping of a whole file, unmapped on destruction
+ */
+class MappedFile {
+    private:
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+    #ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+    #endif
+
+    public:
+        MappedFile(string filename);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        const unsigned char* getData() const;
+        size_t getSize() const;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+#define POOL_SLAB_SIZE 16 // Objects per slab when the pool runs out of free slots
+
+/**
+ * Fixed size objects carved out of large slabs, released objects go back to a free list and are reused
+ * Used for objects that come and go during a level (streamed chunks), the slabs are only freed with the pool
+ * Thread safe, objects can be acquired on one thread and released on another
+ */
+template <typename T> class ObjectPool {
+    public:
+        /**
+         * Deleter of the pointers handed out by the pool, gives the object back instead of freeing it
+         */
+        struct Releaser {
+            ObjectPool* pool = nullptr;
+            void operator()(T* object) const { pool->release(object); }
+        };
+        typedef unique_ptr<T, Releaser> Pointer;
+
+    private:
+        mutex lock;
+        size_t slabSize;
+        vector<void*> slabs;
+        vector<T*> freeSlots;
+        size_t capacity = 0;
+
+        void addSlab(size_t count) {
+            T* slab = (T*) ::operator new(sizeof(T) * count);
+            slabs.push_back(slab);
+            freeSlots.reserve(capacity + count);
+            for (size_t i = count; i > 0; i--) {
+                freeSlots.push_back(slab + i - 1);
+            }
+            capacity += count;
+        }
+
+    public:
+        ObjectPool(size_t slabSize = POOL_SLAB_SIZE) : slabSize(slabSize) {}
+
+        // Every object has to be released before the pool goes away
+        ~ObjectPool() {
+            for (void* slab : slabs) {
+                ::operator delete(slab);
+            }
+        }
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+
+        /**
+         * Make room for count more objects in one slab, for when the number of objects is known up front
+         */
+        void reserve(size_t count) {
+            lock_guard<mutex> guard(lock);
+            if (count > 0) {
+                addSlab(count);
+            }
+        }
+
+        Pointer acquire() {
+            T* slot;
+            {
+                lock_guard<mutex> guard(lock);
+                if (freeSlots.empty()) {
+                    addSlab(slabSize);
+                }
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            return Pointer(new (slot) T(), Releaser{this});
+        }
+
+        void release(T* object) {
+            object->~T();
+            lock_guard<mutex> guard(lock);
+            freeSlots.push_back(object);
+        }
+
+        size_t getSlabCount() {
+            lock_guard<mutex> guard(lock);
+            return slabs.size();
+        }
+
+        size_t getCapacity() {
+            lock_guard<mutex> guard(lock);
+            return capacity;
+        }
+};
+
+#endif
\ No newline at end of file
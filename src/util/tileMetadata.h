@@ -0,0 +1,107 @@
+#ifndef TILE_METADATA_H
+#define TILE_METADATA_H
+
+#include <array>
+#include <cstdint>
+#include "globalConstants.h"
+
+// Bits of the per tile flags byte
+enum TileFlag : uint8_t {
+    TILE_SOLID = 1 << 0,
+    TILE_DANGEROUS = 1 << 1,
+    TILE_ONE_WAY = 1 << 2, // Only blocks from above
+    TILE_UNLOADED = 1 << 3 // Set at runtime when the chunk holding the tile is not in memory
+};
+
+struct TileInfo {
+    uint8_t flags;
+    // Pixels removed from each side of the tile to get its hitbox
+    uint8_t insetLeft;
+    uint8_t insetTop;
+    uint8_t insetRight;
+    uint8_t insetBottom;
+};
+
+constexpr std::array<int, 61> SOLID_TILES = {
+    2, 3, 4, 
+    26, 27, 28, 29, 30, 
+    51, 52, 53, 54, 55, 
+    76, 77, 78, 79, 80,
+    102, 103, 104,
+    131, 132, 133,
+    236,
+    251, 252, 253, 254, 255,
+    377, 378, 379, 
+    401, 402, 403, 404, 405, 
+    426, 427, 428, 429, 430,
+    431, 432, 433, 436, 437, 438,
+    451, 452, 453, 454, 455,
+    477, 478, 479,
+    621, 622, 623, 624
+};
+
+constexpr std::array<int, 3> DANGEROUS_TILES = {211, 59, 60};
+
+constexpr std::array<int, 0> ONE_WAY_TILES = {};
+
+constexpr std::array<int, 20> LEAVES_TILES = {377, 378, 379, 401, 402, 404, 405, 426, 430, 451, 452, 454, 455, 477, 478, 479, 621, 622, 623, 624};
+
+constexpr std::array<int, 6> BRANCHES_TILES = {431, 432, 433, 436, 437, 438};
+
+/**
+ * Build the metadata of every tile of tiles.png at compile time
+ * Index 0 is used for empty cells (-1), tile type t is at index t + 1
+ */
+constexpr std::array<TileInfo, TILESET_TILE_COUNT + 1> buildTileMetadata() {
+    std::array<TileInfo, TILESET_TILE_COUNT + 1> metadata = {};
+
+    for (int tileType : SOLID_TILES) metadata[tileType + 1].flags |= TILE_SOLID;
+    for (int tileType : ONE_WAY_TILES) metadata[tileType + 1].flags |= TILE_ONE_WAY;
+    // Leaves are smaller than the tile, the top of branches is walkable but not their bottom
+    for (int tileType : BRANCHES_TILES) metadata[tileType + 1].insetBottom = 4;
+    for (int tileType : LEAVES_TILES) {
+        metadata[tileType + 1].insetLeft = 4;
+        metadata[tileType + 1].insetTop = 4;
+        metadata[tileType + 1].insetBottom = 0;
+    }
+    // Hazards only hurt on their upper part
+    for (int tileType : DANGEROUS_TILES) {
+        metadata[tileType + 1].flags |= TILE_DANGEROUS;
+        metadata[tileType + 1] = {metadata[tileType + 1].flags, 0, 4, 0, 0};
+    }
+
+    return metadata;
+}
+
+inline constexpr std::array<TileInfo, TILESET_TILE_COUNT + 1> TILE_METADATA = buildTileMetadata();
+
+constexpr const TileInfo& getTileInfo(int tileType) {
+    return TILE_METADATA[(unsigned int) (tileType + 1) <= (unsigned int) TILESET_TILE_COUNT ? tileType + 1 : 0];
+}
+
+// Check the table against the lists it was built from
+constexpr int countTilesWith(uint8_t flag) {
+    int count = 0;
+    for (const TileInfo& info : TILE_METADATA) {
+        count += (info.flags & flag) != 0;
+    }
+    return count;
+}
+
+constexpr bool allTilesHave(const int* tileTypes, int count, uint8_t flag) {
+    for (int i = 0; i < count; i++) {
+        if (!(getTileInfo(tileTypes[i]).flags & flag)) return false;
+    }
+    return true;
+}
+
+static_assert(countTilesWith(TILE_SOLID) == (int) SOLID_TILES.size(), "Solid tiles are listed twice");
+static_assert(countTilesWith(TILE_DANGEROUS) == (int) DANGEROUS_TILES.size(), "Dangerous tiles are listed twice");
+static_assert(allTilesHave(SOLID_TILES.data(), SOLID_TILES.size(), TILE_SOLID), "Solid tile missing from the table");
+static_assert(allTilesHave(DANGEROUS_TILES.data(), DANGEROUS_TILES.size(), TILE_DANGEROUS), "Dangerous tile missing from the table");
+static_assert(getTileInfo(-1).flags == 0 && getTileInfo(TILESET_TILE_COUNT).flags == 0, "Out of range tiles must be empty");
+static_assert(getTileInfo(377).insetLeft == 4 && getTileInfo(377).insetTop == 4 && getTileInfo(377).insetBottom == 0, "Leaves hitbox");
+static_assert(getTileInfo(431).insetTop == 0 && getTileInfo(431).insetBottom == 4, "Branches hitbox");
+static_assert(getTileInfo(211).insetTop == 4 && getTileInfo(211).insetBottom == 0, "Hazards hitbox");
+
+#endif
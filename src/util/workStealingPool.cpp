@@ -0,0 +1,119 @@
+#include "workStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) {
+    threadCount = max<size_t>(1, threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.push_back(make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (thread& worker : threads) {
+        worker.join();
+    }
+}
+
+/**
+ * Queue a job, queues are filled in turn so work starts evenly spread
+ */
+void WorkStealingPool::submit(function<void()> job) {
+    pendingJobs++;
+    {
+        lock_guard<mutex> lock(stateMutex);
+        WorkerQueue& queue = *queues[nextQueue];
+        nextQueue = (nextQueue + 1) % queues.size();
+        {
+            lock_guard<mutex> queueLock(queue.lock);
+            queue.jobs.push_back(move(job));
+        }
+        queuedJobs++;
+    }
+    workAvailable.notify_one();
+}
+
+/**
+ * Take the newest job of the worker's own queue, or steal the oldest job of another queue
+ */
+bool WorkStealingPool::takeJob(size_t worker, function<void()>& job) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        WorkerQueue& queue = *queues[(worker + i) % queues.size()];
+        lock_guard<mutex> lock(queue.lock);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            job = move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = move(queue.jobs.front());
+            queue.jobs.pop_front();
+            stolenJobs++;
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t worker) {
+    while (true) {
+        {
+            unique_lock<mutex> lock(stateMutex);
+            workAvailable.wait(lock, [this] { return stopping || queuedJobs > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+
+        function<void()> job;
+        if (!takeJob(worker, job)) {
+            continue;
+        }
+        {
+            lock_guard<mutex> lock(stateMutex);
+            queuedJobs--;
+        }
+
+        try {
+            job();
+        } catch (...) {
+            lock_guard<mutex> lock(stateMutex);
+            if (!firstError) {
+                firstError = current_exception();
+            }
+        }
+
+        if (--pendingJobs == 0) {
+            lock_guard<mutex> lock(stateMutex);
+            allDone.notify_all();
+        }
+    }
+}
+
+/**
+ * Block until every submitted job has finished, then rethrow the first exception a job threw since the last wait
+ */
+void WorkStealingPool::wait() {
+    unique_lock<mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pendingJobs == 0; });
+    if (firstError) {
+        exception_ptr error = firstError;
+        firstError = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+size_t WorkStealingPool::getThreadCount() const {
+    return threads.size();
+}
+
+size_t WorkStealingPool::getStolenJobs() const {
+    return stolenJobs;
+}
@@ -0,0 +1,55 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed set of threads running jobs, each thread has its own queue and takes work from the 
+ * other queues when its own is empty, so uneven jobs (short and long replays) still keep every core busy
+ * An exception thrown by a job does not stop its thread, the first one is rethrown by wait
+ */
+class WorkStealingPool {
+    private:
+        struct WorkerQueue {
+            mutex lock;
+            deque<function<void()>> jobs;
+        };
+
+        vector<unique_ptr<WorkerQueue>> queues;
+        vector<thread> threads;
+
+        mutex stateMutex;
+        condition_variable workAvailable;
+        condition_variable allDone;
+        size_t queuedJobs = 0; // Jobs waiting in a queue, protected by stateMutex
+        atomic<size_t> pendingJobs{0}; // Jobs submitted and not finished yet
+        atomic<size_t> stolenJobs{0};
+        size_t nextQueue = 0;
+        exception_ptr firstError; // Thrown by a job, rethrown by wait, protected by stateMutex
+        bool stopping = false;
+
+        bool takeJob(size_t worker, function<void()>& job);
+        void workerLoop(size_t worker);
+
+    public:
+        WorkStealingPool(size_t threadCount = thread::hardware_concurrency());
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+        void submit(function<void()> job);
+        void wait();
+        size_t getThreadCount() const;
+        size_t getStolenJobs() const;
+};
+
+#endif
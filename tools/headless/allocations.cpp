@@ -0,0 +1,28 @@
+#include <cstdlib>
+#include <new>
+#include "headless.h"
+
+atomic<size_t> allocationCount{0};
+atomic<size_t> allocatedBytes{0};
+atomic<size_t> freeCount{0};
+
+void* operator new(size_t size) {
+    allocationCount++;
+    allocatedBytes += size;
+    void* pointer = malloc(max<size_t>(size, 1));
+    if (pointer == nullptr) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        freeCount++;
+    }
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
\ No newline at end of file
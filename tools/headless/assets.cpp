@@ -0,0 +1,95 @@
+#include <iostream>
+#include "headless.h"
+
+/**
+ * Load and unload a level several times, counting the allocations each load and unload makes
+ */
+int benchLoad(const string& levelFilename, int repeats) {
+    size_t loadAllocations = 0, loadBytes = 0, retained = 0, unloadFrees = 0;
+    double loadTime = 0;
+    for (int i = 0; i < repeats; i++) {
+        size_t allocations = allocationCount, bytes = allocatedBytes, frees = freeCount;
+        auto start = chrono::steady_clock::now();
+        unique_ptr<Level> level = make_unique<Level>(levelFilename, LEVEL_TILESET);
+        loadTime += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        if (i == 0) {
+            cout << "level arena:  " << level->getArena().getUsedBytes() << " bytes in " << level->getArena().getBlockCount() << " blocks, " 
+                << level->getChunkPool().getCapacity() << " chunk slots in " << level->getChunkPool().getSlabCount() << " slabs" << endl;
+        }
+        loadAllocations += allocationCount - allocations;
+        loadBytes += allocatedBytes - bytes;
+        retained += (allocationCount - allocations) - (freeCount - frees);
+
+        frees = freeCount;
+        level = nullptr;
+        unloadFrees += freeCount - frees;
+    }
+
+    cout << "level load:   " << loadAllocations / repeats << " allocations, " << loadBytes / repeats / 1024 << "KB, " 
+        << loadTime / repeats << "us, " << retained / repeats << " still allocated once loaded" << endl;
+    cout << "level unload: " << unloadFrees / repeats << " frees" << endl;
+    return 0;
+}
+
+/**
+ * Start the game like the windowed build does, textures are decoded but not uploaded
+ */
+int benchStartup(const string& levelFilename) {
+    AssetCache& assets = getAssetCache();
+    auto start = chrono::steady_clock::now();
+    Game::prefetchAssets(LEVEL_TILESET);
+
+    HeadlessGame fixture(levelFilename);
+    double gameTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    assets.waitAll();
+    double readyTime = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    size_t decodes = assets.getDecodeCount();
+    size_t hits = assets.getHitCount();
+
+    // The next level uses the same images, they are prefetched before the current ones are released
+    Game::prefetchAssets(LEVEL_TILESET);
+    assets.releasePrefetched();
+
+    cout << "startup:    " << decodes << " assets decoded (" << assets.getDecodeSeconds() * 1000 << "ms of decoding), " << hits << " cache hits" << endl;
+    cout << "game ready: " << gameTime << "ms, every asset decoded after " << readyTime << "ms" << endl;
+    cout << "next level: " << assets.getDecodeCount() - decodes << " assets decoded, " << assets.getHitCount() - hits << " cache hits, " 
+        << assets.getLiveAssetCount() << " assets in use" << endl;
+    return 0;
+}
+
+#define HEADLESS_MAX_TEXTURE_SIZE 4096 // Without a graphics context the GPU cannot be asked, every GPU the game targets supports at least this
+
+/**
+ * Pack the images drawn by the game without uploading them, check the packing and time it
+ * Rectangles are compared with their padding, so a missing gap on either side of two images is an overlap
+ */
+int benchAtlas() {
+    const char* filenames[] = {LEVEL_TILESET, BACKGROUND_SPRITE_FILENAME, PLAYER_SPRITE_FILENAME, TUTORIAL_ARROW_FILENAME, SACRED_FRUIT_FILENAME};
+    vector<Vector2u> sizes;
+    size_t usedPixels = 0;
+    for (const char* filename : filenames) {
+        sizes.push_back(getAssetCache().load(filename).getImage().getSize());
+        usedPixels += (size_t) sizes.back().x * sizes.back().y;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<Vector2u> positions;
+    Vector2u size = packAtlas(sizes, HEADLESS_MAX_TEXTURE_SIZE, positions);
+    double packTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        IntRect rect(Vector2i(positions[i]), Vector2i(sizes[i] + Vector2u(ATLAS_PADDING, ATLAS_PADDING)));
+        if (positions[i].x + sizes[i].x > size.x || positions[i].y + sizes[i].y > size.y) {
+            throw runtime_error(string(filenames[i]) + " goes past the atlas");
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (rect.findIntersection(IntRect(Vector2i(positions[j]), Vector2i(sizes[j] + Vector2u(ATLAS_PADDING, ATLAS_PADDING)))).has_value()) {
+                throw runtime_error(string(filenames[i]) + " overlaps " + filenames[j]);
+            }
+        }
+    }
+
+    cout << "atlas: " << sizeof(filenames) / sizeof(filenames[0]) << " images in " << size.x << "x" << size.y << ", " 
+        << usedPixels * 100 / ((size_t) size.x * size.y) << "% used, packed in " << packTime << "us" << endl;
+    return 0;
+}
\ No newline at end of file
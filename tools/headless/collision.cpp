@@ -0,0 +1,103 @@
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include "headless.h"
+#include "../../src/sys/levelQuery.h"
+
+#define COLLISION_SCRIPT_TICKS (60 * TICK_RATE) // Length of the scripted run when no recording is given
+
+const int COLLISION_FRAME_RATES[] = {30, 60, 120, 1000};
+
+/**
+ * Deepest overlap between a hitbox and the solid pixels of the tiles, 0 when it is clear of them
+ * One way tiles are left out, the player jumps through them
+ */
+static float getSolidOverlap(const Level& level, FloatRect hitbox) {
+    float depth = 0;
+    forEachOverlap(level, hitbox, TILE_SOLID, [&](const TileHit& hit) {
+        if (!(level.getTiles().getFlags(hit.tile.x, hit.tile.y) & TILE_ONE_WAY)) {
+            depth = max(depth, hit.distance);
+        }
+        return false;
+    });
+    return depth;
+}
+
+/**
+ * Save the headless script played on LEVEL_FILENAME to a recording, so every frame rate plays the same ticks
+ */
+static string recordScript(uint64_t ticks) {
+    string filename = (filesystem::temp_directory_path() / "collision_script.rpl").string();
+    InputRecorder recorder = InputRecorder(filename, LEVEL_FILENAME, TICK_RATE);
+    HeadlessGame fixture(LEVEL_FILENAME);
+    for (uint64_t tick = 0; tick < ticks; tick++) {
+        fixture.step(tick, &recorder);
+    }
+    recorder.finish(ticks, fixture.game.getResult());
+    return filename;
+}
+
+/**
+ * Play a recording in frames of a frame rate, each going through the fixed tick accumulator of Game::runTicks like Game::run does
+ * The last frame is cut short so the run ends on the last tick of the recording
+ * Returns the number of frames ending with the player inside a solid tile
+ */
+static uint64_t playAtFrameRate(const string& recordingFilename, int frameRate, uint64_t& frames, float& maxDepth, RunResult& result) {
+    InputReplay replay = InputReplay(recordingFilename);
+    HeadlessGame fixture(replay.getLevelFilename());
+    Game& game = fixture.game;
+    game.setReplay(&replay);
+    const float frameTime = 1.0f / frameRate;
+    uint64_t overlaps = 0;
+    frames = 0;
+    maxDepth = 0;
+
+    while (game.getTickCount() < replay.getLength()) {
+        game.runTicks(min(frameTime, (float) (replay.getLength() - game.getTickCount()) / TICK_RATE), fixture.input);
+        frames++;
+
+        float depth = getSolidOverlap(fixture.level, game.getPlayer().getHitbox().getGlobalBounds());
+        overlaps += depth > 0;
+        maxDepth = max(maxDepth, depth);
+    }
+    result = game.getResult();
+    return overlaps;
+}
+
+/**
+ * Check the swept collisions of the player: whatever the frame rate, no frame of a run ends with its hitbox inside a solid tile
+ * and the run ends exactly where it did when it was recorded
+ * Runs are recordings, or the headless script on LEVEL_FILENAME when none is given
+ */
+int checkCollisions(const vector<string>& recordingFilenames) {
+    vector<string> runs = recordingFilenames.empty() ? vector<string>{recordScript(COLLISION_SCRIPT_TICKS)} : recordingFilenames;
+    uint64_t failures = 0;
+    for (const string& recordingFilename : runs) {
+        InputReplay recording = InputReplay(recordingFilename);
+        if (recording.getTickRate() != TICK_RATE) {
+            throw runtime_error("Recording was made at another tick rate");
+        }
+        if (!recording.isComplete()) {
+            throw runtime_error("Recording was cut short, it has no end position to compare");
+        }
+        RunResult expected = recording.getResult();
+
+        cout << (recordingFilenames.empty() ? "scripted run" : recordingFilename) << " on " << recording.getLevelFilename() << ", "
+            << fixed << setprecision(1) << (double) recording.getLength() / TICK_RATE << "s, recorded run ends at "
+            << setprecision(3) << expected.playerPosition.x << ", " << expected.playerPosition.y << ":" << endl;
+        for (int frameRate : COLLISION_FRAME_RATES) {
+            uint64_t frames;
+            float maxDepth;
+            RunResult result;
+            uint64_t overlaps = playAtFrameRate(recordingFilename, frameRate, frames, maxDepth, result);
+            // Positions are compared bit for bit like replays, the ticks are the same whatever the frame rate
+            bool diverged = memcmp(&expected.playerPosition, &result.playerPosition, sizeof(Vector2f)) != 0;
+            failures += overlaps + diverged;
+            cout << setw(6) << frameRate << " Hz: " << setw(6) << frames << " frames, " << overlaps << " inside a solid tile (deepest "
+                << maxDepth << "px), ends at " << result.playerPosition.x << ", " << result.playerPosition.y
+                << (diverged ? ", DIVERGED" : "") << endl;
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
\ No newline at end of file
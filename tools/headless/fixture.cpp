@@ -0,0 +1,64 @@
+#include "headless.h"
+
+void pressKey(uint64_t tick, Keyboard::Scancode key, Input& input, InputRecorder* recorder) {
+    input.updateKeyPress(key);
+    if (recorder != nullptr) {
+        recorder->recordKeyPress(tick, key);
+    }
+}
+
+void releaseKey(uint64_t tick, Keyboard::Scancode key, Input& input, InputRecorder* recorder) {
+    input.updateKeyRelease(key);
+    if (recorder != nullptr) {
+        recorder->recordKeyRelease(tick, key);
+    }
+}
+
+void scriptInput(uint64_t tick, Input& input, InputRecorder* recorder) {
+    if (tick == 0) {
+        pressKey(tick, Keyboard::Scancode::Right, input, recorder);
+    }
+    if (tick % TICK_RATE == 0) {
+        pressKey(tick, Keyboard::Scancode::Space, input, recorder);
+    } else if (tick % TICK_RATE == TICK_RATE / 4) {
+        releaseKey(tick, Keyboard::Scancode::Space, input, recorder);
+    }
+    if (tick % (TICK_RATE * 5 / 2) == TICK_RATE / 2) {
+        pressKey(tick, Keyboard::Scancode::A, input, recorder);
+        releaseKey(tick, Keyboard::Scancode::A, input, recorder);
+    }
+}
+
+HeadlessGame::HeadlessGame(const string& levelFilename) 
+    : camera(SCREEN_RESOLUTION), level(levelFilename, LEVEL_TILESET), player(Vector2f(level.getSpawnPosition())), 
+    game(player, camera, level) {}
+
+/**
+ * Play one tick of the scripted run
+ */
+void HeadlessGame::step(uint64_t tick, InputRecorder* recorder) {
+    scriptInput(tick, input, recorder);
+    game.update(input);
+    input.clear();
+}
+
+Arguments::Arguments(int count, char** values) : count(count), values(values) {}
+
+bool Arguments::has(int index) const {
+    return index < count;
+}
+
+string Arguments::text(int index, const string& fallback) const {
+    return has(index) ? values[index] : fallback;
+}
+
+uint64_t Arguments::number(int index, uint64_t fallback) const {
+    return has(index) ? stoull(values[index]) : fallback;
+}
+
+string Arguments::required(int index, const string& name) const {
+    if (!has(index)) {
+        throw runtime_error("Missing " + name + " argument");
+    }
+    return values[index];
+}
\ No newline at end of file
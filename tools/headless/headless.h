@@ -0,0 +1,80 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "../../src/sys/game.h"
+
+using namespace std;
+using namespace sf;
+
+#define HEADLESS_DEFAULT_TICKS 100000
+
+// Every allocation of the program goes through the operator new of allocations.cpp, benchmarks compare these before and after
+extern atomic<size_t> allocationCount;
+extern atomic<size_t> allocatedBytes;
+extern atomic<size_t> freeCount;
+
+void scriptInput(uint64_t tick, Input& input, InputRecorder* recorder);
+
+/**
+ * A level played without a window, set up like the game does
+ * The player is driven by a fixed script: hold right, jump every second and dash every 2.5 seconds
+ * Game keeps its own copies of the camera and the player, the ones it moves are game.getCamera() and game.getPlayer()
+ */
+struct HeadlessGame {
+    Camera camera;
+    Level level;
+    Player player;
+    Game game;
+    Input input;
+
+    HeadlessGame(const string& levelFilename);
+    void step(uint64_t tick, InputRecorder* recorder = nullptr);
+};
+
+/**
+ * Arguments following the name of a mode, missing ones take a default value
+ */
+class Arguments {
+    private:
+        int count;
+        char** values;
+
+    public:
+        Arguments(int count, char** values);
+        bool has(int index) const;
+        string text(int index, const string& fallback) const;
+        uint64_t number(int index, uint64_t fallback) const;
+        string required(int index, const string& name) const;
+};
+
+// simulation.cpp
+int runLevel(const string& levelFilename, uint64_t ticks, const string& recordingFilename);
+int checkReplay(const string& recordingFilename);
+int benchSnapshots(const string& levelFilename, uint64_t ticks);
+int benchEntities(const string& levelFilename, size_t count);
+int benchSystems(size_t count);
+
+// assets.cpp
+int benchLoad(const string& levelFilename, int repeats);
+int benchStartup(const string& levelFilename);
+int benchAtlas();
+
+// rendering.cpp
+int benchAnimation(size_t count);
+int benchSprites(size_t count);
+int benchHud(const string& levelFilename, int frames);
+
+// queries.cpp
+int benchQueries(const string& levelFilename, size_t count);
+
+// collision.cpp
+int checkCollisions(const vector<string>& recordingFilenames);
+
+// scaling.cpp
+int benchTiles(const vector<string>& levelFilenames, uint64_t ticks);
+int benchCulling(const vector<string>& levelFilenames, uint64_t frames);
+
+#endif
\ No newline at end of file
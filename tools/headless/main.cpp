@@ -0,0 +1,100 @@
+#include <cstring>
+#include <iostream>
+#include "headless.h"
+
+/**
+ * Run the game logic without a window or a display: simulate levels, check recordings and benchmark the systems of the game
+ * Each mode is a line of the table below, running headless with an unknown mode lists them
+ */
+
+struct Mode {
+    const char* name; // Empty for the mode used when the first argument is not a mode
+    const char* usage;
+    const char* description;
+    int (*run)(const Arguments& arguments);
+};
+
+const Mode MODES[] = {
+    {"", "[level] [ticks]", "simulate a level (defaults to LEVEL_FILENAME) for a number of ticks (defaults to 100000)",
+        [](const Arguments& arguments) { 
+            return runLevel(arguments.text(0, LEVEL_FILENAME), arguments.number(1, HEADLESS_DEFAULT_TICKS), ""); 
+        }},
+    {"--record", "<file> [level] [ticks]", "same, and save the inputs to a recording",
+        [](const Arguments& arguments) { 
+            return runLevel(arguments.text(1, LEVEL_FILENAME), arguments.number(2, HEADLESS_DEFAULT_TICKS), arguments.required(0, "recording")); 
+        }},
+    {"--replay", "<file>", "play a recording back and check the player ends exactly where it did",
+        [](const Arguments& arguments) { return checkReplay(arguments.required(0, "recording")); }},
+    {"--snapshots", "[level] [ticks]", "time snapshot capture, restore and rewind, and check rewinding gives back every tick",
+        [](const Arguments& arguments) { 
+            return benchSnapshots(arguments.text(0, LEVEL_FILENAME), arguments.number(1, HEADLESS_DEFAULT_TICKS)); 
+        }},
+    {"--entities", "[count] [level]", "time entity overlap queries and game ticks with thousands of entities (defaults to 10000)",
+        [](const Arguments& arguments) { return benchEntities(arguments.text(1, LEVEL_FILENAME), arguments.number(0, 10000)); }},
+    {"--ecs", "[count]", "time each entity system per entity (defaults to 100000 entities)",
+        [](const Arguments& arguments) { return benchSystems(arguments.number(0, 100000)); }},
+    {"--load", "[level] [repeats]", "count the allocations made by loading and unloading a level (defaults to 100 loads)",
+        [](const Arguments& arguments) { return benchLoad(arguments.text(0, LEVEL_FILENAME), arguments.number(1, 100)); }},
+    {"--startup", "[level]", "count the assets decoded at startup and time how long until they are all ready",
+        [](const Arguments& arguments) { return benchStartup(arguments.text(0, LEVEL_FILENAME)); }},
+    {"--animation", "[count]", "time advancing animators (defaults to 50000) against one object per animator",
+        [](const Arguments& arguments) { return benchAnimation(arguments.number(0, 50000)); }},
+    {"--sprites", "[count]", "time batching a frame of sprites (defaults to 10000) and count the draw calls it takes",
+        [](const Arguments& arguments) { return benchSprites(arguments.number(0, 10000)); }},
+    {"--atlas", "", "pack the images of the world like the texture atlas does and check no two overlap",
+        [](const Arguments&) { return benchAtlas(); }},
+    {"--hud", "[frames] [level]", "time writing the HUD each frame (defaults to 10000 frames) against formatting strings",
+        [](const Arguments& arguments) { return benchHud(arguments.text(1, LEVEL_FILENAME), arguments.number(0, 10000)); }},
+    {"--collision", "[recording...]", "play runs (defaults to the script) at 30 to 1000 frames per second, check the player never ends inside a tile and ends where it was recorded",
+        [](const Arguments& arguments) {
+            vector<string> recordingFilenames;
+            for (int i = 0; arguments.has(i); i++) {
+                recordingFilenames.push_back(arguments.text(i, ""));
+            }
+            return checkCollisions(recordingFilenames);
+        }},
+    {"--tiles", "[ticks] [level...]", "time the tile work of a frame (defaults to 10000 ticks) on levels of different sizes",
+        [](const Arguments& arguments) {
+            vector<string> levelFilenames;
+            for (int i = 1; arguments.has(i); i++) {
+                levelFilenames.push_back(arguments.text(i, ""));
+            }
+            return benchTiles(levelFilenames.empty() ? vector<string>{LEVEL_FILENAME} : levelFilenames, arguments.number(0, 10000));
+        }},
+    {"--culling", "[frames] [level...]", "count the level draws and vertices of each frame (defaults to 2000) culled by the view and not culled",
+        [](const Arguments& arguments) {
+            vector<string> levelFilenames;
+            for (int i = 1; arguments.has(i); i++) {
+                levelFilenames.push_back(arguments.text(i, ""));
+            }
+            return benchCulling(levelFilenames.empty() ? vector<string>{LEVEL_FILENAME} : levelFilenames, arguments.number(0, 2000));
+        }},
+    {"--queries", "[count] [level]", "check raycasts, ground and overlap queries (defaults to 10000) against brute force and time them",
+        [](const Arguments& arguments) { return benchQueries(arguments.text(1, LEVEL_FILENAME), arguments.number(0, 10000)); }},
+};
+
+void printUsage() {
+    cerr << "Usage:" << endl;
+    for (const Mode& mode : MODES) {
+        string command = string("headless ") + mode.name + (mode.name[0] != '\0' ? " " : "") + mode.usage;
+        cerr << "  " << command << string(max<int>(1, 44 - command.size()), ' ') << mode.description << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool named = argc > 1 && strncmp(argv[1], "--", 2) == 0;
+    for (const Mode& mode : MODES) {
+        if (named ? strcmp(argv[1], mode.name) != 0 : mode.name[0] != '\0') {
+            continue;
+        }
+        try {
+            int first = named ? 2 : 1;
+            return mode.run(Arguments(argc - first, argv + first));
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    printUsage();
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "headless.h"
+#include "../../src/sys/levelQuery.h"
+
+/**
+ * Brute force versions of the level queries: every solid pixel of every tile is tested on its own
+ * They share no code with levelQuery.cpp so that the two can be compared
+ */
+
+static bool isSolidPixel(const Level& level, int x, int y, int pixelX, int pixelY) {
+    return (level.getTiles().getFlags(x, y) & TILE_SOLID) && (level.getTileMask(x, y).rows[pixelY] >> pixelX & 1);
+}
+
+/**
+ * Closest solid pixel crossed by a ray, each pixel of the tiles around the ray is a box tested with the slab method
+ */
+static TileHit bruteRaycast(const Level& level, Vector2f origin, Vector2f direction, float maxDistance) {
+    TileHit result;
+    result.distance = INFINITY;
+    direction = direction / hypot(direction.x, direction.y);
+    Vector2f end = origin + direction * maxDistance;
+    IntRect range = getTileRange(FloatRect({min(origin.x, end.x), min(origin.y, end.y)}, {abs(end.x - origin.x), abs(end.y - origin.y)}));
+    for (int y = max(0, range.position.y); y < min((int) level.getSize().y, range.position.y + range.size.y); y++) {
+        for (int x = max(0, range.position.x); x < min((int) level.getSize().x, range.position.x + range.size.x); x++) {
+            for (int pixelY = 0; pixelY < (int) TILE_SIZE.y; pixelY++) {
+                for (int pixelX = 0; pixelX < (int) TILE_SIZE.x; pixelX++) {
+                    if (!isSolidPixel(level, x, y, pixelX, pixelY)) {
+                        continue;
+                    }
+                    Vector2f start = getTileOrigin(x, y) + Vector2f(pixelX, pixelY);
+                    Vector2f enter, exit;
+                    enter.x = direction.x != 0 ? min((start.x - origin.x) / direction.x, (start.x + 1 - origin.x) / direction.x)
+                        : (origin.x >= start.x && origin.x < start.x + 1 ? -INFINITY : INFINITY);
+                    exit.x = direction.x != 0 ? max((start.x - origin.x) / direction.x, (start.x + 1 - origin.x) / direction.x) : INFINITY;
+                    enter.y = direction.y != 0 ? min((start.y - origin.y) / direction.y, (start.y + 1 - origin.y) / direction.y)
+                        : (origin.y >= start.y && origin.y < start.y + 1 ? -INFINITY : INFINITY);
+                    exit.y = direction.y != 0 ? max((start.y - origin.y) / direction.y, (start.y + 1 - origin.y) / direction.y) : INFINITY;
+                    float distance = max({enter.x, enter.y, 0.0f});
+                    if (distance > min(exit.x, exit.y) || distance > maxDistance || distance >= result.distance) {
+                        continue;
+                    }
+                    result.hit = true;
+                    result.tile = {x, y};
+                    result.distance = distance;
+                    result.position = origin + direction * distance;
+                    result.normal = distance == 0 ? Vector2i(0, 0)
+                        : enter.x > enter.y ? Vector2i(direction.x > 0 ? -1 : 1, 0) : Vector2i(0, direction.y > 0 ? -1 : 1);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Closest top of the solid pixels of a tile in the columns of a box, for every tile of the columns around the box
+ */
+static TileHit bruteSolidBelow(const Level& level, FloatRect box, float maxDistance) {
+    TileHit result;
+    result.distance = INFINITY;
+    float bottom = box.position.y + box.size.y;
+    IntRect range = getTileRange(box);
+    for (int y = 0; y < (int) level.getSize().y; y++) {
+        for (int x = max(0, range.position.x - 1); x <= min((int) level.getSize().x - 1, range.position.x + range.size.x); x++) {
+            Vector2f origin = getTileOrigin(x, y);
+            float top = INFINITY;
+            for (int pixelY = 0; pixelY < (int) TILE_SIZE.y && top == INFINITY; pixelY++) {
+                for (int pixelX = 0; pixelX < (int) TILE_SIZE.x; pixelX++) {
+                    if (origin.x + pixelX + 1 > box.position.x && origin.x + pixelX < box.position.x + box.size.x
+                            && isSolidPixel(level, x, y, pixelX, pixelY)) {
+                        top = origin.y + pixelY;
+                        break;
+                    }
+                }
+            }
+            // A tile whose pixels start above the bottom of the box is not below it
+            if (top >= bottom && top - bottom <= maxDistance && top - bottom < result.distance) {
+                result.hit = true;
+                result.tile = {x, y};
+                result.distance = top - bottom;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Number of tiles around a box with a solid pixel overlapping it
+ */
+static int bruteOverlaps(const Level& level, FloatRect box) {
+    int count = 0;
+    IntRect range = getTileRange(box);
+    for (int y = max(0, range.position.y - 1); y <= min((int) level.getSize().y - 1, range.position.y + range.size.y); y++) {
+        for (int x = max(0, range.position.x - 1); x <= min((int) level.getSize().x - 1, range.position.x + range.size.x); x++) {
+            Vector2f origin = getTileOrigin(x, y);
+            bool overlaps = false;
+            for (int pixelY = 0; pixelY < (int) TILE_SIZE.y && !overlaps; pixelY++) {
+                for (int pixelX = 0; pixelX < (int) TILE_SIZE.x && !overlaps; pixelX++) {
+                    overlaps = origin.x + pixelX + 1 > box.position.x && origin.x + pixelX < box.position.x + box.size.x
+                        && origin.y + pixelY + 1 > box.position.y && origin.y + pixelY < box.position.y + box.size.y
+                        && isSolidPixel(level, x, y, pixelX, pixelY);
+                }
+            }
+            count += overlaps;
+        }
+    }
+    return count;
+}
+
+static bool nearCorner(Vector2f position, float margin) {
+    return abs(position.x - round(position.x)) <= margin && abs(position.y - round(position.y)) <= margin;
+}
+
+struct QueryTimes {
+    double query = 0;
+    double bruteForce = 0;
+    int mismatches = 0;
+};
+
+static void reportQueries(const string& name, const QueryTimes& times, size_t count) {
+    cout << name << fixed << setprecision(0) << count / times.query << " queries/s, brute force " << count / times.bruteForce
+        << " queries/s (" << setprecision(1) << times.bruteForce / times.query << "x), " << times.mismatches << " mismatches" << endl;
+}
+
+/**
+ * Run random queries on a level, check each against its brute force version and compare their speed
+ * Distances match within MAX_QUERY_ERROR pixels, rays ending or grazing a pixel corner that close to their hit can go either way
+ * and are not compared
+ */
+int benchQueries(const string& levelFilename, size_t count) {
+    const float MAX_QUERY_ERROR = 0.01f;
+    Level level = Level(levelFilename, LEVEL_TILESET);
+    level.loadAllChunks();
+    Vector2f worldSize = {(float) level.getSize().x * TILE_SIZE.x, (float) level.getSize().y * TILE_SIZE.y};
+    mt19937 random(1);
+    uniform_real_distribution<float> randomX(0, worldSize.x), randomY(0, worldSize.y), randomAngle(0, 2 * M_PI);
+    uniform_real_distribution<float> randomLength(0, 10 * TILE_SIZE.x), randomSize(1, 2 * TILE_SIZE.x);
+
+    vector<Vector2f> origins(count), directions(count), ends(count);
+    vector<float> lengths(count);
+    vector<FloatRect> boxes(count);
+    for (size_t i = 0; i < count; i++) {
+        float angle = randomAngle(random);
+        origins[i] = {randomX(random), randomY(random)};
+        directions[i] = {cos(angle), sin(angle)};
+        lengths[i] = randomLength(random);
+        ends[i] = origins[i] + directions[i] * lengths[i];
+        boxes[i] = FloatRect({randomX(random), randomY(random)}, {randomSize(random), randomSize(random)});
+    }
+
+    // Falling straight down from the spawn lands on the top of a tile
+    Vector2f spawn = Vector2f(level.getSpawnPosition());
+    TileHit ground = firstSolidBelow(level, spawn, worldSize.y);
+    int failures = 0;
+    if (!ground.hit || ground.normal != Vector2i(0, -1) || abs(ground.position.y - round(ground.position.y)) > MAX_QUERY_ERROR) {
+        cout << "no ground below the spawn" << endl;
+        failures++;
+    }
+
+    QueryTimes raycastTimes, sightTimes, belowTimes, overlapTimes;
+    vector<TileHit> hits(count);
+    vector<int> counts(count);
+    float distanceSum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        hits[i] = raycast(level, origins[i], directions[i], lengths[i]);
+    }
+    raycastTimes.query = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        TileHit expected = bruteRaycast(level, origins[i], directions[i], lengths[i]);
+        distanceSum += expected.hit ? expected.distance : 0;
+        if (expected.hit && (expected.distance > lengths[i] - MAX_QUERY_ERROR || nearCorner(expected.position, MAX_QUERY_ERROR))) {
+            continue;
+        }
+        raycastTimes.mismatches += hits[i].hit != expected.hit || (expected.hit && (abs(hits[i].distance - expected.distance) > MAX_QUERY_ERROR
+            || (hits[i].normal != expected.normal && expected.distance > 0)));
+    }
+    raycastTimes.bruteForce = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<bool> visible(count);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        visible[i] = hasLineOfSight(level, origins[i], ends[i]);
+    }
+    sightTimes.query = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        TileHit expected = bruteRaycast(level, origins[i], directions[i], lengths[i]);
+        bool ambiguous = expected.hit && (expected.distance > lengths[i] - MAX_QUERY_ERROR || nearCorner(expected.position, MAX_QUERY_ERROR));
+        sightTimes.mismatches += visible[i] == expected.hit && !ambiguous;
+    }
+    sightTimes.bruteForce = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        hits[i] = firstSolidBelow(level, boxes[i], lengths[i]);
+    }
+    belowTimes.query = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        TileHit expected = bruteSolidBelow(level, boxes[i], lengths[i]);
+        distanceSum += expected.hit ? expected.distance : 0;
+        belowTimes.mismatches += hits[i].hit != expected.hit || (expected.hit && abs(hits[i].distance - expected.distance) > MAX_QUERY_ERROR);
+    }
+    belowTimes.bruteForce = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        counts[i] = forEachOverlap(level, boxes[i], TILE_SOLID, [&](const TileHit& hit) {
+            distanceSum += hit.distance;
+            return false;
+        });
+    }
+    overlapTimes.query = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        overlapTimes.mismatches += counts[i] != bruteOverlaps(level, boxes[i]);
+    }
+    overlapTimes.bruteForce = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << count << " random queries on " << levelFilename << " (" << level.getSize().x << "x" << level.getSize().y << " tiles, checksum "
+        << (int) distanceSum << ")" << endl;
+    reportQueries("raycast:         ", raycastTimes, count);
+    reportQueries("hasLineOfSight:  ", sightTimes, count);
+    reportQueries("firstSolidBelow: ", belowTimes, count);
+    reportQueries("forEachOverlap:  ", overlapTimes, count);
+    failures += raycastTimes.mismatches + sightTimes.mismatches + belowTimes.mismatches + overlapTimes.mismatches;
+    return failures > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include <cmath>
+#include <random>
+#include <iostream>
+#include "headless.h"
+
+/**
+ * Animator the way the player used to animate: clip parameters passed on every call and the frame rectangle built on every frame change
+ */
+struct ObjectAnimator {
+    IntRect rect;
+    int currentFrame = 0;
+    float animationTimer = 0.0f;
+    float totalAnimationTimer = 0.0f;
+
+    bool animate(float deltaTime, float timePerFrame, int offsetX, int offsetY, int totalFrames, bool repeat) {
+        animationTimer += deltaTime;
+        totalAnimationTimer += deltaTime;
+        if (totalAnimationTimer >= totalFrames * timePerFrame && !repeat) {
+            return true;
+        }
+        if (animationTimer > timePerFrame) {
+            currentFrame = (currentFrame + 1) % totalFrames;
+            rect = IntRect({currentFrame * 32 + offsetX, offsetY}, {32, 32});
+            animationTimer = 0.0f;
+        }
+        return false;
+    }
+};
+
+/**
+ * Advance animators playing random clips of the clip file, all at once or one object at a time
+ */
+int benchAnimation(size_t count) {
+    const AnimationLibrary& library = getAnimations();
+    const float deltaTime = 1.0f / TICK_RATE;
+    const int ticks = 1000;
+    mt19937 random(1);
+
+    Animators animators;
+    vector<ObjectAnimator> objects(count);
+    for (size_t i = 0; i < count; i++) {
+        animators.add(random() % library.getClipCount());
+    }
+
+    vector<FiredEvent> fired;
+    size_t firedCount = 0;
+    auto start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        fired.clear();
+        library.update(animators, deltaTime, &fired);
+        firedCount += fired.size();
+    }
+    double libraryTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ticks / count;
+
+    // Same clips, each object reads the parameters of its clip and keeps its own rectangle
+    size_t finished = 0;
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (size_t i = 0; i < count; i++) {
+            const AnimationClip& clip = library.getClip(animators.clip[i]);
+            IntRect first = library.getFrameRect(animators.clip[i], 0);
+            finished += objects[i].animate(deltaTime, clip.frameDuration, first.position.x, first.position.y, clip.frameCount, clip.loop);
+        }
+    }
+    double objectTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ticks / count;
+
+    size_t finishedAnimators = count_if(animators.finished.begin(), animators.finished.end(), [](uint8_t done) { return done; });
+    cout << "animators: " << count << " playing " << library.getClipCount() << " clips, " << finishedAnimators << " finished, "
+        << firedCount << " events over " << ticks << " ticks" << endl;
+    cout << "clip tables: " << libraryTime << "ns per animator per tick" << endl;
+    cout << "objects:     " << objectTime << "ns per animator per tick" << endl;
+    return 0;
+}
+
+/**
+ * Batch a frame of sprites over and over without drawing it, most sprites come from the atlas and the others from a second texture
+ */
+int benchSprites(size_t count) {
+    Texture atlasTexture, otherTexture;
+    mt19937 random(1);
+    uniform_real_distribution<float> randomPosition(0, 1000);
+    vector<Sprite> sprites;
+    vector<uint8_t> layers;
+    for (size_t i = 0; i < count; i++) {
+        sprites.push_back(Sprite(random() % 10 == 0 ? otherTexture : atlasTexture, IntRect({0, 0}, Vector2i(TILE_SIZE))));
+        sprites.back().setPosition({randomPosition(random), randomPosition(random)});
+        layers.push_back(random() % 2 == 0 ? LAYER_PLAYER : LAYER_ENTITIES);
+    }
+
+    SpriteBatch batch;
+    const int frames = 1000;
+    size_t drawCalls = 0;
+    size_t allocations = 0;
+    double batchTime = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        size_t allocationsBefore = allocationCount;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            batch.add(sprites[i], layers[i]);
+        }
+        drawCalls = batch.build();
+        batchTime += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        batch.clear();
+        if (frame > 0) {
+            allocations += allocationCount - allocationsBefore;
+        }
+    }
+
+    cout << "sprites:   " << count << " over 2 layers and 2 textures" << endl;
+    cout << "draws:     " << count << " -> " << drawCalls << " per frame" << endl;
+    cout << "batching:  " << batchTime / frames << "us per frame, " << batchTime * 1000 / frames / count << "ns per sprite, " 
+        << allocations / (frames - 1) << " allocations per frame" << endl;
+    return 0;
+}
+
+/**
+ * Timer and statistics formatted like the game did before the HUD, a string built every frame
+ */
+string formatStrings(const Game& game, const Level& level, float frameTime) {
+    float seconds = game.getClock().getElapsedSeconds();
+    int decimalPart = (seconds * pow(10, 3)) - ((int) seconds * pow(10, 3));
+    string timer = ((int) seconds >= 10 ? to_string((int) seconds) : "0" + to_string((int) seconds)) + "."
+        + (decimalPart >= 10 ? to_string(decimalPart) : "0" + to_string(decimalPart));
+
+    const RewindBuffer& history = game.getRewindBuffer();
+    string stats = to_string(1.0f / frameTime) + "\n" + to_string(2) + " ticks\n" + to_string(level.getDrawnChunks()) + " drawn";
+    stats += "\n" + to_string(game.getActiveEntityCount()) + " active " 
+        + to_string(game.getEntityWorld().size() - game.getActiveEntityCount()) + " asleep";
+    stats += "\n" + to_string(history.getSnapshotCount() / TICK_RATE) + "s rewind " 
+        + to_string(history.getUsedBytes() / 1024) + "/" + to_string(history.getMemoryBudget() / 1024) + "KB";
+    return timer + stats;
+}
+
+/**
+ * Play a level at 60 frames per second of 2 ticks and write the HUD with the statistics shown after each frame
+ */
+int benchHud(const string& levelFilename, int frames) {
+    HeadlessGame fixture(levelFilename);
+    Game& game = fixture.game;
+
+    const float frameTime = 1.0f / 60;
+    double hudTime = 0, stringTime = 0;
+    size_t hudAllocations = 0, stringAllocations = 0, formattedCharacters = 0;
+    size_t rewrittenBefore = game.getHud().getRewrittenCharacters();
+    uint64_t tick = 0;
+    int frame = 0;
+    for (; frame < frames && !game.isFinished(); frame++) {
+        for (int i = 0; i < 2; i++, tick++) {
+            fixture.step(tick);
+        }
+
+        size_t allocationsBefore = allocationCount;
+        auto start = chrono::steady_clock::now();
+        game.updateHud(frameTime, true);
+        hudTime += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        hudAllocations += allocationCount - allocationsBefore;
+
+        allocationsBefore = allocationCount;
+        start = chrono::steady_clock::now();
+        formattedCharacters += formatStrings(game, fixture.level, frameTime).size();
+        stringTime += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        stringAllocations += allocationCount - allocationsBefore;
+    }
+
+    frames = frame;
+    size_t rewritten = game.getHud().getRewrittenCharacters() - rewrittenBefore;
+    cout << "frames:  " << frames << ", " << tick << " ticks" << endl;
+    cout << "hud:     " << hudTime / frames << "ns per frame, " << (double) hudAllocations / frames << " allocations per frame, "
+        << (double) rewritten / frames << " characters rewritten per frame" << endl;
+    cout << "strings: " << stringTime / frames << "ns per frame, " << (double) stringAllocations / frames << " allocations per frame, "
+        << (double) formattedCharacters / frames << " characters formatted per frame (before laying out the texts)" << endl;
+    return 0;
+}
\ No newline at end of file
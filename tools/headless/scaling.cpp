@@ -0,0 +1,165 @@
+#include <iomanip>
+#include <iostream>
+#include "headless.h"
+#include "../../src/sys/levelFile.h"
+#include "../../src/util/mappedFile.h"
+
+/**
+ * Go through the tiles under a view like the F1 overlay does, returns the number of solid or dangerous tiles
+ */
+static int walkViewTiles(const TileMap& tiles, const View& view) {
+    Vector2f viewPosition = view.getCenter() - view.getSize() / 2.0f;
+    int startX = viewPosition.x / TILE_SIZE.x;
+    int startY = viewPosition.y / TILE_SIZE.y;
+    int endX = startX + SCREEN_RESOLUTION.x / TILE_SIZE.x + 1;
+    int endY = startY + SCREEN_RESOLUTION.y / TILE_SIZE.y + 1;
+
+    int count = 0;
+    for (int x = startX; x <= endX; x++) {
+        for (int y = startY; y <= endY; y++) {
+            if (tiles.contains(x, y) && (tiles.getFlags(x, y) & (TILE_SOLID | TILE_DANGEROUS))) {
+                count += tiles.getHitbox(x, y).size.x > 0;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Play the scripted run on levels of different sizes and time what a frame does with the tiles:
+ * the game tick (player collisions, streaming, entities) and the walk over the tiles of the view
+ * Neither goes through the whole map, so their cost should not grow with its area
+ */
+int benchTiles(const vector<string>& levelFilenames, uint64_t ticks) {
+    const uint64_t warmupTicks = TICK_RATE;
+    double firstTickTime = 0;
+    size_t firstArea = 0;
+    for (const string& levelFilename : levelFilenames) {
+        HeadlessGame fixture(levelFilename);
+        for (uint64_t tick = 0; tick < warmupTicks; tick++) {
+            fixture.step(tick);
+        }
+
+        double tickTime = 0, walkTime = 0;
+        int walkedTiles = 0;
+        for (uint64_t tick = warmupTicks; tick < warmupTicks + ticks; tick++) {
+            auto start = chrono::steady_clock::now();
+            fixture.step(tick);
+            auto stepped = chrono::steady_clock::now();
+            walkedTiles += walkViewTiles(fixture.level.getTiles(), fixture.game.getCamera().getView());
+            tickTime += chrono::duration<double, micro>(stepped - start).count();
+            walkTime += chrono::duration<double, micro>(chrono::steady_clock::now() - stepped).count();
+        }
+        tickTime /= ticks;
+        walkTime /= ticks;
+
+        Vector2u size = fixture.level.getSize();
+        size_t area = (size_t) size.x * size.y;
+        if (firstArea == 0) {
+            firstTickTime = tickTime;
+            firstArea = area;
+        }
+        cout << levelFilename << " (" << size.x << "x" << size.y << " tiles):" << endl;
+        cout << fixed << setprecision(2) << "  tick:      " << tickTime << "us, " << tickTime / firstTickTime << "x the first level for "
+            << setprecision(0) << (double) area / firstArea << "x its area" << endl;
+        cout << setprecision(2) << "  view walk: " << walkTime << "us (" << walkedTiles / ticks << " solid tiles on screen)" << endl;
+        cout << "  resident:  " << fixture.level.getResidentBytes() / 1024 << "KB of " << fixture.level.getFullLevelBytes() / 1024 << "KB, "
+            << fixture.level.getSynchronousLoads() << " chunks loaded by the simulation" << endl;
+    }
+    return 0;
+}
+
+/**
+ * Vertices of the background and main layer meshes of every chunk of a level, built on the CPU like Level does before uploading them
+ * The whole level is read from the file, even the chunks a game would never stream in
+ */
+static vector<array<size_t, 2>> countChunkVertices(const string& levelFilename, Vector2u& chunkCount) {
+    AssetHandle tileset = getAssetCache().load(LEVEL_TILESET);
+    TileMeshBuilder meshBuilder = TileMeshBuilder(tileset.getImage());
+    vector<array<size_t, 2>> chunkVertices;
+    vector<Vertex> vertices;
+
+    auto buildChunk = [&](const int16_t* background, const int16_t* main, int stride, Vector2u size, Vector2u chunkPosition) {
+        Vector2u chunkTiles = {min<unsigned int>(CHUNK_SIZE, size.x - chunkPosition.x), min<unsigned int>(CHUNK_SIZE, size.y - chunkPosition.y)};
+        array<size_t, 2> counts;
+        meshBuilder.build(vertices, background, stride, chunkPosition, chunkTiles);
+        counts[0] = vertices.size();
+        meshBuilder.build(vertices, main, stride, chunkPosition, chunkTiles);
+        counts[1] = vertices.size();
+        chunkVertices.push_back(counts);
+    };
+
+    if (isBinaryLevelFile(levelFilename)) {
+        MappedFile file(levelFilename);
+        LevelFileView view = viewBinaryLevel(file.getData(), file.getSize());
+        chunkCount = view.chunkCount;
+        for (unsigned int i = 0; i < chunkCount.x * chunkCount.y; i++) {
+            Vector2u chunkPosition = {i % chunkCount.x * CHUNK_SIZE, i / chunkCount.x * CHUNK_SIZE};
+            buildChunk(view.chunks[i].backgroundTileTypes, view.chunks[i].tileTypes, CHUNK_SIZE, {view.header->width, view.header->height}, chunkPosition);
+        }
+    } else {
+        LevelData data = readTextLevel(levelFilename);
+        chunkCount = getChunkCount(data.size);
+        for (unsigned int i = 0; i < chunkCount.x * chunkCount.y; i++) {
+            Vector2u chunkPosition = {i % chunkCount.x * CHUNK_SIZE, i / chunkCount.x * CHUNK_SIZE};
+            size_t first = chunkPosition.x + (size_t) chunkPosition.y * data.size.x;
+            buildChunk(&data.backgroundLayer[first], &data.mainLayer[first], data.size.x, data.size, chunkPosition);
+        }
+    }
+    return chunkVertices;
+}
+
+/**
+ * Go through a range of chunks like Level::draw does, counting the draw calls it would make and their vertices instead of making them
+ */
+static void countDraws(const vector<array<size_t, 2>>& chunkVertices, Vector2u chunkCount, IntRect range, size_t& draws, size_t& vertexCount) {
+    for (int layer = 0; layer < 2; layer++) {
+        for (int chunkY = range.position.y; chunkY < range.position.y + range.size.y; chunkY++) {
+            for (int chunkX = range.position.x; chunkX < range.position.x + range.size.x; chunkX++) {
+                size_t vertices = chunkVertices[chunkX + chunkY * chunkCount.x][layer];
+                if (vertices > 0) {
+                    draws++;
+                    vertexCount += vertices;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Compare the level draws of each frame of the scripted run with the chunks culled by the view against drawing every chunk
+ * There is no GPU here: a draw is counted with its vertices, and the time is what the CPU spends going through the chunks
+ */
+int benchCulling(const vector<string>& levelFilenames, uint64_t frames) {
+    for (const string& levelFilename : levelFilenames) {
+        Vector2u chunkCount;
+        vector<array<size_t, 2>> chunkVertices = countChunkVertices(levelFilename, chunkCount);
+        IntRect allChunks({0, 0}, Vector2i(chunkCount));
+
+        HeadlessGame fixture(levelFilename);
+        size_t culledDraws = 0, culledVertices = 0, maxCulledVertices = 0, fullDraws = 0, fullVertices = 0;
+        double culledTime = 0, fullTime = 0;
+        for (uint64_t frame = 0; frame < frames; frame++) {
+            fixture.step(frame);
+
+            size_t vertices = 0;
+            auto start = chrono::steady_clock::now();
+            countDraws(chunkVertices, chunkCount, fixture.level.getVisibleChunks(fixture.game.getCamera().getView()), culledDraws, vertices);
+            auto culled = chrono::steady_clock::now();
+            countDraws(chunkVertices, chunkCount, allChunks, fullDraws, fullVertices);
+            culledTime += chrono::duration<double, micro>(culled - start).count();
+            fullTime += chrono::duration<double, micro>(chrono::steady_clock::now() - culled).count();
+            culledVertices += vertices;
+            maxCulledVertices = max(maxCulledVertices, vertices);
+        }
+
+        Vector2u size = fixture.level.getSize();
+        cout << levelFilename << " (" << size.x << "x" << size.y << " tiles, " << chunkCount.x * chunkCount.y << " chunks):" << endl;
+        cout << fixed << setprecision(1) << "  culled:      " << (double) culledDraws / frames << " draws, " << culledVertices / frames
+            << " vertices (at most " << maxCulledVertices << "), " << setprecision(2) << culledTime / frames << "us per frame" << endl;
+        cout << setprecision(1) << "  whole level: " << (double) fullDraws / frames << " draws, " << fullVertices / frames << " vertices, "
+            << setprecision(2) << fullTime / frames << "us per frame" << endl;
+        cout << setprecision(1) << "  culling draws " << (double) fullVertices / max<size_t>(culledVertices, 1) << "x fewer vertices" << endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include <cstring>
+#include <deque>
+#include <random>
+#include <iostream>
+#include "headless.h"
+
+/**
+ * Print how fast a run was simulated and where the player ended
+ */
+void reportRun(const string& levelFilename, Game& game, uint64_t ticks, double seconds) {
+    Vector2f position = game.getPlayer().getHitbox().getPosition();
+    cout << levelFilename << ": " << ticks << " ticks (" << ticks / TICK_RATE << "s of game time) in " << seconds << "s" << endl;
+    cout << "ticks per second: " << (uint64_t) (ticks / seconds) << endl;
+    cout << "player position:  " << position.x << ", " << position.y << (game.isFinished() ? " (level finished)" : "") << endl;
+}
+
+/**
+ * Play the scripted run on a level, its inputs are saved to a recording when a filename is given
+ */
+int runLevel(const string& levelFilename, uint64_t ticks, const string& recordingFilename) {
+    unique_ptr<InputRecorder> recorder;
+    if (!recordingFilename.empty()) {
+        recorder = make_unique<InputRecorder>(recordingFilename, levelFilename, TICK_RATE);
+    }
+    HeadlessGame fixture(levelFilename);
+
+    auto start = chrono::steady_clock::now();
+    uint64_t tick = 0;
+    for (; tick < ticks && !fixture.game.isFinished(); tick++) {
+        fixture.step(tick, recorder.get());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    reportRun(levelFilename, fixture.game, tick, seconds);
+
+    if (recorder != nullptr) {
+        recorder->finish(tick, fixture.game.getResult());
+        cout << "recording:        " << recorder->getBytesWritten() << " bytes, " 
+            << recorder->getBytesWritten() / max(1.0, (double) tick / TICK_RATE) << " bytes per second of game time" << endl;
+    }
+    return 0;
+}
+
+/**
+ * Play a recording back as fast as possible and check the player ends exactly where it did
+ */
+int checkReplay(const string& recordingFilename) {
+    InputReplay replay = InputReplay(recordingFilename);
+    if (replay.getTickRate() != TICK_RATE) {
+        throw runtime_error("Recording was made at another tick rate");
+    }
+    HeadlessGame fixture(replay.getLevelFilename());
+    Game& game = fixture.game;
+
+    auto start = chrono::steady_clock::now();
+    uint64_t tick = 0;
+    for (; !game.isFinished() && !replay.isFinished(tick); tick++) {
+        replay.apply(tick, fixture.input);
+        game.update(fixture.input);
+        fixture.input.clear();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    reportRun(replay.getLevelFilename(), game, tick, seconds);
+
+    // Positions are compared bit for bit, any difference means the simulation is not deterministic
+    RunResult expected = replay.getResult();
+    RunResult result = game.getResult();
+    if (!replay.isComplete()) {
+        cout << "recording was cut short, nothing to compare" << endl;
+        return 1;
+    } else if (memcmp(&expected.playerPosition, &result.playerPosition, sizeof(Vector2f)) != 0 
+            || expected.levelTicks != result.levelTicks || expected.levelFinished != result.levelFinished) {
+        cout << "replay diverged, the recorded run ended at " << expected.playerPosition.x << ", " << expected.playerPosition.y << endl;
+        return 1;
+    } else {
+        cout << "replay matches the recorded run" << endl;
+    }
+    return 0;
+}
+
+/**
+ * Play the scripted run, then go back through the rewind history
+ */
+int benchSnapshots(const string& levelFilename, uint64_t ticks) {
+    HeadlessGame fixture(levelFilename);
+    Game& game = fixture.game;
+
+    // Keep the last snapshots in full to check the rewound ones against them
+    deque<GameSnapshot> expected;
+    GameSnapshot snapshot;
+    game.captureSnapshot(snapshot);
+    expected.push_back(snapshot);
+    for (uint64_t tick = 0; tick < ticks && !game.isFinished(); tick++) {
+        fixture.step(tick);
+        game.captureSnapshot(snapshot);
+        expected.push_back(snapshot);
+        if (expected.size() > game.getRewindBuffer().getSnapshotCount()) {
+            expected.pop_front();
+        }
+    }
+    const RewindBuffer& history = game.getRewindBuffer();
+    size_t snapshots = history.getSnapshotCount();
+    size_t usedBytes = history.getUsedBytes();
+
+    const int repeats = 100000;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        game.captureSnapshot(snapshot);
+    }
+    double captureTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repeats;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        game.restoreSnapshot(snapshot);
+    }
+    double restoreTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repeats;
+
+    // Timed on a copy, the game itself is rewound tick by tick and compared
+    Game timedGame = game;
+    size_t rewinds = 0;
+    start = chrono::steady_clock::now();
+    while (timedGame.rewind()) {
+        rewinds++;
+    }
+    double rewindTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / max((size_t) 1, rewinds);
+
+    size_t mismatches = 0;
+    expected.pop_back();
+    while (game.rewind()) {
+        game.captureSnapshot(snapshot);
+        if (memcmp((void*) &snapshot, (void*) &expected.back(), sizeof(GameSnapshot)) != 0) {
+            mismatches++;
+        }
+        expected.pop_back();
+    }
+
+    cout << "snapshot:      " << sizeof(GameSnapshot) << " bytes, capture " << captureTime << "us, restore " << restoreTime << "us" << endl;
+    cout << "rewind:        " << rewindTime << "us per tick (decode and restore)" << endl;
+    cout << "history:       " << snapshots << " ticks (" << (double) snapshots / TICK_RATE << "s) in " << usedBytes << " bytes, " 
+        << usedBytes / max((size_t) 1, snapshots) << " bytes per tick" << endl;
+    cout << "memory budget: " << history.getMemoryBudget() << " bytes" << endl;
+    if (mismatches > 0) {
+        cout << mismatches << " rewound ticks differ from the recorded ones" << endl;
+        return 1;
+    }
+    cout << "every rewound tick matches" << endl;
+    return 0;
+}
+
+/**
+ * Scatter entities over a level, compare the grid with testing every entity, then run the game with all of them
+ */
+int benchEntities(const string& levelFilename, size_t count) {
+    HeadlessGame fixture(levelFilename);
+    Game& game = fixture.game;
+    const Level& level = fixture.level;
+
+    Vector2f worldSize = Vector2f(level.getSize().x * TILE_SIZE.x, level.getSize().y * TILE_SIZE.y);
+    mt19937 random(1);
+    uniform_real_distribution<float> randomX(0, worldSize.x - TILE_SIZE.x);
+    uniform_real_distribution<float> randomY(0, worldSize.y - TILE_SIZE.y);
+    uniform_real_distribution<float> randomStep(-4, 4);
+
+    EntityGrid grid = EntityGrid(worldSize);
+    vector<FloatRect> bounds;
+    for (size_t i = 0; i < count; i++) {
+        bounds.push_back(FloatRect({randomX(random), randomY(random)}, Vector2f(TILE_SIZE)));
+        grid.insert(bounds.back());
+        game.addEntity({MapEntityType::TUTORIAL_ARROW, bounds.back().position, "Entity " + to_string(i)});
+    }
+
+    // A tenth of the entities move every tick, then a player sized box sweeping the level looks for overlaps
+    const int ticks = 10000;
+    double moveTime = 0, gridTime = 0, bruteForceTime = 0;
+    size_t tested = 0, mismatches = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count / 10; i++) {
+            uint32_t entity = random() % count;
+            bounds[entity].position += Vector2f(randomStep(random), randomStep(random));
+            grid.move(entity, bounds[entity]);
+        }
+        auto moved = chrono::steady_clock::now();
+
+        FloatRect box = FloatRect({fmod(tick * 7.0f, worldSize.x), fmod(tick * 3.0f, worldSize.y)}, HITBOX_SIZE);
+        size_t gridHits = 0;
+        tested += grid.query(box, [&](uint32_t) { gridHits++; });
+        auto queried = chrono::steady_clock::now();
+
+        size_t bruteForceHits = 0;
+        for (const FloatRect& entityBounds : bounds) {
+            if (entityBounds.findIntersection(box).has_value()) {
+                bruteForceHits++;
+            }
+        }
+        auto bruteForced = chrono::steady_clock::now();
+
+        mismatches += gridHits != bruteForceHits;
+        moveTime += chrono::duration<double, micro>(moved - start).count();
+        gridTime += chrono::duration<double, micro>(queried - moved).count();
+        bruteForceTime += chrono::duration<double, micro>(bruteForced - queried).count();
+    }
+
+    // Only the entities around the view are updated, the others sleep
+    size_t activeEntities = 0;
+    auto start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        fixture.step(tick);
+        activeEntities += game.getActiveEntityCount();
+    }
+    double tickTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / ticks;
+
+    cout << count << " entities" << endl;
+    cout << "overlap query:  grid " << gridTime / ticks << "us (" << (double) tested / ticks << " entities tested), every entity " 
+        << bruteForceTime / ticks << "us" << endl;
+    cout << "grid update:    " << moveTime / ticks / (count / 10) * 1000 << "ns per moved entity" << endl;
+    cout << "game tick:      " << tickTime << "us, " << activeEntities / ticks << " entities awake on average" << endl;
+    if (mismatches > 0) {
+        cout << mismatches << " queries found other entities than testing every entity" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Spawn arrows and fruits over a large area and time the entity systems on all of them
+ */
+int benchSystems(size_t count) {
+    const Vector2f worldSize = {8192, 8192};
+    mt19937 random(1);
+    uniform_real_distribution<float> randomX(0, worldSize.x - TILE_SIZE.x);
+    uniform_real_distribution<float> randomY(0, worldSize.y - TILE_SIZE.y);
+
+    EntityWorld world;
+    EntityGrid grid = EntityGrid(worldSize);
+    for (size_t i = 0; i < count; i++) {
+        MapEntityType type = i % 2 == 0 ? MapEntityType::TUTORIAL_ARROW : MapEntityType::SACRED_FRUIT;
+        Entity entity = world.spawn({type, {randomX(random), randomY(random)}, type == MapEntityType::TUTORIAL_ARROW ? "Entity " + to_string(i) : ""});
+        grid.insert(world.getBounds(entity));
+    }
+    // The awake entities come from a grid query, in the order of the cells
+    vector<Entity> listed;
+    grid.query(FloatRect({0, 0}, worldSize), [&](uint32_t entity) { listed.push_back(entity); });
+
+    const float deltaTime = 1.0f / TICK_RATE;
+    const int ticks = 1000;
+    auto start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        world.animate(deltaTime);
+    }
+    double animateTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ticks / count;
+
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        world.animate(listed, deltaTime);
+    }
+    double animateListedTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ticks / count;
+
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (Entity entity : listed) {
+            world.wake(entity, deltaTime * 100);
+        }
+    }
+    double wakeTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ticks / count;
+
+    // A player sized box sweeping the area, the trigger system runs on what it overlaps
+    vector<Entity> previous, current;
+    size_t touched = 0;
+    bool finished = false;
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks * 100; tick++) {
+        FloatRect box = FloatRect({fmod(tick * 7.0f, worldSize.x), fmod(tick * 3.0f, worldSize.y)}, HITBOX_SIZE);
+        swap(previous, current);
+        current.clear();
+        grid.query(box, [&](uint32_t entity) { current.push_back(entity); });
+        world.updateTriggers(previous, current, finished);
+        touched += current.size();
+    }
+    double triggerTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (ticks * 100);
+
+    cout << count << " entities, " << world.getBytesPerEntity() << " bytes of components each" << endl;
+    cout << "animation:      " << animateTime << "ns per entity (every entity in order), " 
+        << animateListedTime << "ns per entity (from a grid query)" << endl;
+    cout << "wake:           " << wakeTime << "ns per entity" << endl;
+    cout << "triggers:       " << triggerTime << "ns per query, " << (double) touched / (ticks * 100) << " entities overlapped" << endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "../src/sys/levelFile.h"
+#include "../src/sys/chunkStreamer.h"
+#include "../src/util/mappedFile.h"
+
+/**
+ * Compile text .lvl files into the .lvlb format loaded by Level through a memory mapping
+ *
+ * Usage:
+ *  levelCompiler <level.lvl> [output.lvlb]   compile one level (output defaults to the same name with .lvlb)
+ *  levelCompiler --all [directory]           compile every .lvl of a directory (defaults to assets/levels)
+ *  levelCompiler --bench <level.lvl> [runs]  compare the load time of the text and compiled files
+ *  levelCompiler --generate <width> <height> <output.lvlb>  write a synthetic level of any size, chunk by chunk
+ *  levelCompiler --stream <level.lvlb> [budget]  sweep a camera across a compiled level and report peak resident memory
+ */
+
+string compiledFilename(const string& filename) {
+    return filesystem::path(filename).replace_extension(LEVEL_BINARY_EXTENSION).string();
+}
+
+void compile(const string& input, const string& output) {
+    LevelData level = readTextLevel(input);
+    writeBinaryLevel(output, level);
+    cout << input << " -> " << output << " (" << level.size.x << "x" << level.size.y << ", " 
+        << level.entities.size() << " entities, " << filesystem::file_size(output) << " bytes)" << endl;
+}
+
+/**
+ * Time both load paths up to the point where the tile layers are in memory, as Level uses them
+ */
+void bench(const string& input, int runs) {
+    string output = compiledFilename(input);
+    compile(input, output);
+
+    auto start = chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (int i = 0; i < runs; i++) {
+        LevelData level = readTextLevel(input);
+        checksum += level.mainLayer[0] + level.backgroundLayer[0];
+    }
+    double textTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / runs;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        MappedFile file(output);
+        LevelFileView view = viewBinaryLevel(file.getData(), file.getSize());
+        size_t chunkCount = (size_t) view.chunkCount.x * view.chunkCount.y;
+        vector<LevelFileChunk> chunks(view.chunks, view.chunks + chunkCount);
+        checksum += chunks[0].tileTypes[0] + chunks[0].backgroundTileTypes[0];
+    }
+    double binaryTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / runs;
+
+    cout << "text:     " << textTime << " us/load" << endl;
+    cout << "compiled: " << binaryTime << " us/load" << endl;
+    cout << "speedup:  " << textTime / binaryTime << "x (checksum " << checksum << ")" << endl;
+}
+
+/**
+ * Rolling ground with a few gaps, only one chunk is in memory at a time so the size is only limited by the disk
+ */
+void generateLevel(unsigned int width, unsigned int height, const string& output) {
+    ofstream file(output, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open " + output);
+    }
+
+    auto groundHeight = [&](unsigned int x) {
+        return (unsigned int) (height * 0.6f + sin(x * 0.05f) * height * 0.1f);
+    };
+
+    LevelFileHeader header = {};
+    header.magic = LEVEL_BINARY_MAGIC;
+    header.version = LEVEL_BINARY_VERSION;
+    header.width = width;
+    header.height = height;
+    header.spawnX = 2 * TILE_SIZE.x;
+    header.spawnY = (groundHeight(2) - 3) * TILE_SIZE.y;
+    header.chunkSize = CHUNK_SIZE;
+    header.entityCount = 1;
+    file.write((const char*) &header, sizeof(header));
+
+    Vector2u chunkCount = getChunkCount({width, height});
+    LevelFileChunk chunk;
+    for (unsigned int chunkY = 0; chunkY < chunkCount.y; chunkY++) {
+        for (unsigned int chunkX = 0; chunkX < chunkCount.x; chunkX++) {
+            for (unsigned int y = 0; y < CHUNK_SIZE; y++) {
+                for (unsigned int x = 0; x < CHUNK_SIZE; x++) {
+                    unsigned int levelX = chunkX * CHUNK_SIZE + x;
+                    unsigned int levelY = chunkY * CHUNK_SIZE + y;
+                    bool inside = levelX < width && levelY < height;
+                    bool gap = levelX % 97 > 92;
+                    int16_t tileType = -1;
+                    if (inside && !gap && levelY >= groundHeight(levelX)) {
+                        tileType = levelY == groundHeight(levelX) ? 27 : 52;
+                    }
+                    chunk.tileTypes[x + y * CHUNK_SIZE] = tileType;
+                    chunk.backgroundTileTypes[x + y * CHUNK_SIZE] = -1;
+                }
+            }
+            file.write((const char*) &chunk, sizeof(chunk));
+        }
+    }
+
+    LevelFileEntity sacredFruit = {};
+    memcpy(sacredFruit.tag, "SF", 2);
+    sacredFruit.x = (width - 3) * TILE_SIZE.x;
+    sacredFruit.y = (groundHeight(width - 3) - 2) * TILE_SIZE.y;
+    file.write((const char*) &sacredFruit, sizeof(sacredFruit));
+
+    cout << output << " (" << width << "x" << height << ", " << filesystem::file_size(output) << " bytes)" << endl;
+}
+
+/**
+ * Move a camera sized region from the spawn to the right edge of the level while the chunks stream in
+ */
+void streamReport(const string& input, size_t budget) {
+    ObjectPool<TileChunk> chunkPool; // Declared first so the chunks go back to it before it is destroyed
+    ChunkStreamer streamer(input, chunkPool, budget);
+    const LevelFileView& view = streamer.getView();
+    Vector2u size = {view.header->width, view.header->height};
+    TileMap tiles(size);
+
+    vector<int> installed;
+    vector<int> evicted;
+    size_t peakResidentChunks = 0;
+    size_t missingTileFrames = 0;
+
+    FloatRect region(Vector2f(view.header->spawnX, view.header->spawnY) - Vector2f(SCREEN_RESOLUTION) / 2.0f, Vector2f(SCREEN_RESOLUTION));
+    streamer.prime(tiles, region, installed);
+
+    for (float x = region.position.x; x + region.size.x < size.x * TILE_SIZE.x; x += 8.0f) {
+        region.position.x = x;
+        installed.clear();
+        evicted.clear();
+        streamer.update(tiles, region, installed, evicted);
+        for (int index : evicted) {
+            tiles.releaseChunk(index);
+        }
+        peakResidentChunks = max(peakResidentChunks, tiles.getResidentChunks().size());
+
+        // Tile under the center of the view still being loaded
+        Vector2f center = region.getCenter();
+        if (tiles.getFlags(center.x / TILE_SIZE.x, min<float>(center.y / TILE_SIZE.y, size.y - 1)) & TILE_UNLOADED) {
+            missingTileFrames++;
+        }
+        this_thread::sleep_for(chrono::microseconds(200));
+    }
+
+    size_t totalChunks = (size_t) view.chunkCount.x * view.chunkCount.y;
+    cout << "level:         " << size.x << "x" << size.y << " tiles, " << totalChunks << " chunks" << endl;
+    cout << "fully loaded:  " << totalChunks * sizeof(TileChunk) / 1024 << " KB of tiles" << endl;
+    cout << "peak resident: " << peakResidentChunks << " chunks, " << peakResidentChunks * sizeof(TileChunk) / 1024 << " KB of tiles" << endl;
+    cout << "frames with the view center not loaded yet: " << missingTileFrames << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: levelCompiler <level.lvl> [output.lvlb] | --all [directory] | --bench <level.lvl> [runs]" << endl;
+        cout << "       levelCompiler --generate <width> <height> <output.lvlb> | --stream <level.lvlb> [budget]" << endl;
+        return 1;
+    }
+
+    try {
+        if (strcmp(argv[1], "--all") == 0) {
+            string directory = argc > 2 ? argv[2] : "assets/levels";
+            for (const auto& entry : filesystem::directory_iterator(directory)) {
+                if (entry.path().extension() != ".lvl") {
+                    continue;
+                }
+                try {
+                    compile(entry.path().string(), compiledFilename(entry.path().string()));
+                } catch (const exception& e) {
+                    cerr << entry.path().string() << ": " << e.what() << endl;
+                }
+            }
+        } else if (strcmp(argv[1], "--generate") == 0 && argc > 4) {
+            generateLevel(stoi(argv[2]), stoi(argv[3]), argv[4]);
+        } else if (strcmp(argv[1], "--stream") == 0 && argc > 2) {
+            streamReport(argv[2], argc > 3 ? stoi(argv[3]) : CHUNK_RESIDENCY_BUDGET);
+        } else if (strcmp(argv[1], "--bench") == 0 && argc > 2) {
+            bench(argv[2], argc > 3 ? stoi(argv[3]) : 100);
+        } else {
+            compile(argv[1], argc > 2 ? argv[2] : compiledFilename(argv[1]));
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
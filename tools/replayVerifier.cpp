@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include "../src/sys/game.h"
+#include "../src/util/workStealingPool.h"
+
+/**
+ * Check recorded runs by simulating them again without a window, many at once on every core
+ *
+ * Usage:
+ *  replayVerifier [--threads <count>] <recording.rpl | directory>...   verify recordings and report the level time of each
+ *  replayVerifier --bench <recording.rpl> [copies]                    replays per second with 1 thread up to every core
+ *
+ * Every level is loaded once and shared read-only by all the simulations playing it
+ * Recordings are untrusted: unreadable ones, runs on a level that fails to load and runs longer than MAX_RUN_MINUTES are reported as failures
+ */
+
+#define MAX_RUN_MINUTES 30 // Longer runs are rejected without simulating them
+
+struct Verification {
+    string filename;
+    uint64_t ticks = 0;
+    RunResult result;
+    bool matches = false;
+    string error;
+};
+
+/**
+ * Simulate a recording from the start, the level must be fully loaded (see Level::loadAllChunks)
+ */
+Verification verify(InputReplay replay, Level& level) {
+    Verification verification;
+    if (replay.getTickRate() != TICK_RATE) {
+        verification.error = "recorded at " + to_string(replay.getTickRate()) + " ticks per second";
+        return verification;
+    }
+    if (replay.getLength() > (uint64_t) MAX_RUN_MINUTES * 60 * TICK_RATE) {
+        verification.error = "longer than " + to_string(MAX_RUN_MINUTES) + " minutes";
+        return verification;
+    }
+    Camera camera = Camera(SCREEN_RESOLUTION);
+    Player player = Player(Vector2f(level.getSpawnPosition()));
+    Game game = Game(player, camera, level);
+    Input input = Input();
+
+    // Nothing moves once the level is finished, the rest of the recording does not need to be played
+    uint64_t tick = 0;
+    for (; !replay.isFinished(tick) && !game.isFinished(); tick++) {
+        replay.apply(tick, input);
+        game.update(input);
+        input.clear();
+    }
+
+    verification.ticks = tick;
+    verification.result = game.getResult();
+    const RunResult& expected = replay.getResult();
+    if (!replay.isComplete()) {
+        verification.error = "recording was cut short";
+    } else if (expected.levelFinished != verification.result.levelFinished || expected.levelTicks != verification.result.levelTicks
+            || memcmp(&expected.playerPosition, &verification.result.playerPosition, sizeof(Vector2f)) != 0) {
+        verification.error = "diverged, recorded " + to_string(expected.levelTicks) + " ticks ending at " 
+            + to_string(expected.playerPosition.x) + ", " + to_string(expected.playerPosition.y);
+    } else {
+        verification.matches = true;
+    }
+    return verification;
+}
+
+/**
+ * Load every level played by the recordings once, a level that fails to load is kept as null and its runs fail
+ */
+map<string, unique_ptr<Level>> loadLevels(const vector<InputReplay>& replays) {
+    map<string, unique_ptr<Level>> levels;
+    for (const InputReplay& replay : replays) {
+        string levelFilename = replay.getLevelFilename();
+        if (levels.count(levelFilename) > 0) {
+            continue;
+        }
+        try {
+            levels[levelFilename] = make_unique<Level>(levelFilename, LEVEL_TILESET);
+            levels[levelFilename]->loadAllChunks();
+        } catch (const exception& e) {
+            cerr << levelFilename << ": " << e.what() << endl;
+            levels[levelFilename] = nullptr;
+        }
+    }
+    return levels;
+}
+
+/**
+ * Verify every replay on a pool of threads, returns the time it took in seconds
+ */
+double verifyAll(const vector<InputReplay>& replays, const map<string, unique_ptr<Level>>& levels, size_t threadCount, vector<Verification>& verifications) {
+    verifications = vector<Verification>(replays.size());
+    WorkStealingPool pool(threadCount);
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < replays.size(); i++) {
+        pool.submit([&, i] {
+            // A corrupt recording fails on its own instead of stopping the batch
+            try {
+                Level* level = levels.at(replays[i].getLevelFilename()).get();
+                if (level == nullptr) {
+                    verifications[i].error = "level " + replays[i].getLevelFilename() + " could not be loaded";
+                } else {
+                    verifications[i] = verify(replays[i], *level);
+                }
+            } catch (const exception& e) {
+                verifications[i] = Verification();
+                verifications[i].error = e.what();
+            }
+        });
+    }
+    pool.wait();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void bench(const string& filename, size_t copies) {
+    vector<InputReplay> replays(copies, InputReplay(filename));
+    map<string, unique_ptr<Level>> levels = loadLevels(replays);
+    vector<Verification> verifications;
+
+    double singleThreaded = 0;
+    size_t maxThreads = max(1u, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads = threads * 2 > maxThreads && threads < maxThreads ? maxThreads : threads * 2) {
+        double seconds = verifyAll(replays, levels, threads, verifications);
+        singleThreaded = threads == 1 ? seconds : singleThreaded;
+        cout << setw(3) << threads << " threads: " << fixed << setprecision(1) << copies / seconds << " replays/s, speedup " 
+            << setprecision(2) << singleThreaded / seconds << "x" << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: replayVerifier [--threads <count>] <recording.rpl | directory>... | --bench <recording.rpl> [copies]" << endl;
+        return 1;
+    }
+
+    try {
+        if (strcmp(argv[1], "--bench") == 0 && argc > 2) {
+            bench(argv[2], argc > 3 ? stoi(argv[3]) : 1000);
+            return 0;
+        }
+
+        size_t threadCount = thread::hardware_concurrency();
+        vector<string> filenames;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                threadCount = stoi(argv[++i]);
+            } else if (filesystem::is_directory(argv[i])) {
+                size_t first = filenames.size();
+                for (const auto& entry : filesystem::directory_iterator(argv[i])) {
+                    if (entry.path().extension() == ".rpl") {
+                        filenames.push_back(entry.path().string());
+                    }
+                }
+                sort(filenames.begin() + first, filenames.end());
+            } else {
+                filenames.push_back(argv[i]);
+            }
+        }
+
+        // Recordings that cannot be read fail without being simulated, they are listed after the others
+        vector<InputReplay> replays;
+        vector<string> replayFilenames;
+        vector<Verification> unreadable;
+        for (const string& filename : filenames) {
+            try {
+                replays.push_back(InputReplay(filename));
+                replayFilenames.push_back(filename);
+            } catch (const exception& e) {
+                unreadable.push_back(Verification());
+                unreadable.back().filename = filename;
+                unreadable.back().error = e.what();
+            }
+        }
+        map<string, unique_ptr<Level>> levels = loadLevels(replays);
+
+        vector<Verification> verifications;
+        double seconds = verifyAll(replays, levels, threadCount, verifications);
+        for (size_t i = 0; i < verifications.size(); i++) {
+            verifications[i].filename = replayFilenames[i];
+        }
+        verifications.insert(verifications.end(), unreadable.begin(), unreadable.end());
+
+        int failures = 0;
+        for (size_t i = 0; i < verifications.size(); i++) {
+            const Verification& verification = verifications[i];
+            cout << verification.filename << ": ";
+            if (!verification.matches) {
+                cout << "FAILED, " << verification.error << endl;
+                failures++;
+            } else if (verification.result.levelFinished) {
+                cout << "verified, level finished in " << fixed << setprecision(3) << (double) verification.result.levelTicks / TICK_RATE << "s" << endl;
+            } else {
+                cout << "verified, level not finished" << endl;
+            }
+        }
+        cout << verifications.size() << " replays, " << failures << " failed, " << fixed << setprecision(1) 
+            << replays.size() / seconds << " replays/s on " << threadCount << " threads" << endl;
+        return failures > 0 ? 1 : 0;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,522 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <unordered_set>
+#include "../src/sys/game.h"
+#include "../src/util/workStealingPool.h"
+
+/**
+ * Search for the fastest route through a level by simulating input sequences without a window
+ *
+ * Usage:
+ *  routeSolver [--threads <count>] [--beam <width>] [--record <file>] <level | directory>...   solve levels, fails if one cannot be completed
+ *  routeSolver --bench <level> [width]                                                       search time from 1 thread up to every core
+ *
+ * Beam search over steps of STEP_TICKS ticks: every state of the beam is expanded with each combination of held keys,
+ * the states already reached at an earlier step are dropped, and only the states closest to the sacred fruit are kept,
+ * counting the tile moves a jump and a dash allow.
+ * States are game snapshots, so expanding one is a restore followed by a few ticks.
+ */
+
+#define STEP_TICKS 8 // Ticks between two input changes, 15 decisions per second
+#define DEFAULT_BEAM_WIDTH 1024
+#define MAX_STEPS (TICK_RATE * 90 / STEP_TICKS) // Gives up after 90 seconds of game time
+#define STATE_CELL_PIXELS 4.0f
+#define STATE_CELL_SPEED 64.0f
+#define STATES_PER_TILE 8 // Spreads the beam over the level, enough per tile to keep the run-ups of precise jumps
+#define JUMP_TILES 4 // Tiles a jump rises: 375px/s against 1000px/s² of gravity, about 70 pixels
+#define DASH_TILES 3 // Tiles a dash carries the player without falling, from 525px/s down to the running speed
+#define JOBS_PER_THREAD 4 // Smaller jobs let idle threads steal work
+
+enum SolverKey : uint8_t { KEY_LEFT = 1, KEY_RIGHT = 2, KEY_RUN = 4, KEY_JUMP = 8, KEY_DASH = 16 };
+
+const Keyboard::Scancode SOLVER_SCANCODES[] = { Keyboard::Scancode::Left, Keyboard::Scancode::Right, 
+    Keyboard::Scancode::LShift, Keyboard::Scancode::Space, Keyboard::Scancode::A };
+const char* SOLVER_KEY_NAMES[] = { "left", "right", "run", "jump", "dash" };
+
+struct Node {
+    GameSnapshot snapshot;
+    uint8_t heldKeys = 0;
+    int32_t parent = -1; // Index in the previous step
+    float score = 0.0f; // Moves left to the sacred fruit, lower is better
+    uint32_t tile = 0; // Index of the tile under the center of the player
+    uint64_t hash = 0;
+    uint32_t finishTick = 0; // Tick of the step the level was finished at, 0 if it was not
+};
+
+/**
+ * How a state was reached, kept for every step to rebuild the route
+ */
+struct Step {
+    int32_t parent;
+    uint8_t heldKeys;
+};
+
+struct Route {
+    bool hasGoal = false;
+    bool found = false;
+    RunResult result;
+    uint64_t ticks = 0; // Ticks to simulate to play the route
+    vector<uint8_t> heldKeys; // Held keys for each step
+    size_t expandedStates = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * Every combination of held keys worth trying, running and dashing only make sense with a direction
+ */
+vector<uint8_t> getActions() {
+    vector<uint8_t> actions;
+    for (int direction : {0, (int) KEY_LEFT, (int) KEY_RIGHT}) {
+        for (int jump : {0, (int) KEY_JUMP}) {
+            actions.push_back(direction | jump);
+            if (direction != 0) {
+                actions.push_back(direction | jump | KEY_RUN);
+                actions.push_back(direction | jump | KEY_DASH);
+                actions.push_back(direction | jump | KEY_RUN | KEY_DASH);
+            }
+        }
+    }
+    return actions;
+}
+
+string describeKeys(uint8_t heldKeys) {
+    string description;
+    for (int i = 0; i < 5; i++) {
+        if (heldKeys & (1 << i)) {
+            description += (description.empty() ? "" : "+") + string(SOLVER_KEY_NAMES[i]);
+        }
+    }
+    return description.empty() ? "wait" : description;
+}
+
+/**
+ * Reach of the player in the distance field: a tile, the tiles its jump can still rise and whether it can dash
+ */
+struct Reach {
+    int tile;
+    int rise;
+    bool canDash;
+};
+
+int getReachIndex(Reach reach) {
+    return (reach.tile * (JUMP_TILES + 1) + reach.rise) * 2 + reach.canDash;
+}
+
+/**
+ * Moves to neighbour tiles of a reach, one tile per move: standing on a solid tile gives a full jump and the dash back,
+ * rising takes one tile of the jump, falling ends it and a dash goes sideways without falling
+ */
+void forEachMove(const TileMap& tiles, Reach from, const function<void(Reach)>& callback) {
+    Vector2u size = tiles.getSize();
+    auto isFree = [&](int x, int y) { 
+        return tiles.contains(x, y) && !(tiles.getFlags(x, y) & (TILE_SOLID | TILE_DANGEROUS)); 
+    };
+    auto move = [&](int x, int y, int rise, bool canDash) {
+        if (!isFree(x, y)) {
+            return;
+        }
+        bool grounded = tiles.contains(x, y + 1) && (tiles.getFlags(x, y + 1) & TILE_SOLID) && !(tiles.getFlags(x, y + 1) & TILE_DANGEROUS);
+        callback(grounded ? Reach{(int) (y * size.x + x), JUMP_TILES, true} : Reach{(int) (y * size.x + x), rise, canDash});
+    };
+
+    int x = from.tile % size.x, y = from.tile / size.x;
+    for (int side : {-1, 1}) {
+        if (from.rise > 0) {
+            move(x + side, y, from.rise - 1, from.canDash);
+            if (isFree(x + side, y) || isFree(x, y - 1)) {
+                move(x + side, y - 1, from.rise - 1, from.canDash);
+            }
+        }
+        move(x + side, y + 1, 0, from.canDash);
+        for (int distance = 1; from.canDash && distance <= DASH_TILES && isFree(x + side * distance, y); distance++) {
+            move(x + side * distance, y, 0, false);
+        }
+    }
+    if (from.rise > 0) {
+        move(x, y - 1, from.rise - 1, from.canDash);
+    }
+    move(x, y + 1, 0, from.canDash);
+}
+
+/**
+ * Moves from each reach to the sacred fruit, searched backwards from the fruit over the moves of forEachMove
+ * Unlike a walking distance it knows the player cannot go up further than a jump, it is still only used to rank states
+ */
+vector<int> buildDistanceField(const Level& level, FloatRect goal) {
+    const TileMap& tiles = level.getTiles();
+    Vector2u size = tiles.getSize();
+    int reachCount = size.x * size.y * (JUMP_TILES + 1) * 2;
+    vector<int> distances(reachCount, INT32_MAX);
+
+    Vector2i goalTile = Vector2i(goal.getCenter().x / TILE_SIZE.x, goal.getCenter().y / TILE_SIZE.y);
+    if (!tiles.contains(goalTile.x, goalTile.y)) {
+        return distances;
+    }
+
+    // Moves leading to each reach, in the order of the reaches they come from
+    vector<uint32_t> firstMove(reachCount + 1, 0);
+    vector<uint32_t> moveSources;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int tile = 0; tile < (int) (size.x * size.y); tile++) {
+            for (int rise = 0; rise <= JUMP_TILES; rise++) {
+                for (bool canDash : {false, true}) {
+                    Reach from = {tile, rise, canDash};
+                    forEachMove(tiles, from, [&](Reach to) {
+                        if (pass == 0) {
+                            firstMove[getReachIndex(to) + 1]++;
+                        } else {
+                            moveSources[firstMove[getReachIndex(to)]++] = getReachIndex(from);
+                        }
+                    });
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int i = 0; i < reachCount; i++) {
+                firstMove[i + 1] += firstMove[i];
+            }
+            moveSources.resize(firstMove[reachCount]);
+        } else {
+            // Filling shifted every start to the end of its range
+            for (int i = reachCount; i > 0; i--) {
+                firstMove[i] = firstMove[i - 1];
+            }
+            firstMove[0] = 0;
+        }
+    }
+
+    vector<int> frontier;
+    for (int rise = 0; rise <= JUMP_TILES; rise++) {
+        for (bool canDash : {false, true}) {
+            int index = getReachIndex({(int) (goalTile.y * size.x + goalTile.x), rise, canDash});
+            distances[index] = 0;
+            frontier.push_back(index);
+        }
+    }
+    for (size_t i = 0; i < frontier.size(); i++) {
+        int reach = frontier[i];
+        for (uint32_t move = firstMove[reach]; move < firstMove[reach + 1]; move++) {
+            int source = moveSources[move];
+            if (distances[source] == INT32_MAX) {
+                distances[source] = distances[reach] + 1;
+                frontier.push_back(source);
+            }
+        }
+    }
+    return distances;
+}
+
+/**
+ * States less than STATE_CELL_PIXELS and STATE_CELL_SPEED apart are considered the same, a coarse grid
+ * keeps the search from going through thousands of nearly identical states stuck against the same wall
+ */
+uint64_t hashState(const GameSnapshot& snapshot, uint8_t heldKeys) {
+    const PlayerSnapshot& player = snapshot.player;
+    int64_t values[] = {
+        (int64_t) floor(player.hitboxPosition.x / STATE_CELL_PIXELS), (int64_t) floor(player.hitboxPosition.y / STATE_CELL_PIXELS),
+        (int64_t) floor(player.speed.x / STATE_CELL_SPEED), (int64_t) floor(player.speed.y / STATE_CELL_SPEED),
+        player.dashingState ? (int64_t) floor(player.totalAnimationTimer * TICK_RATE / STEP_TICKS) : 0,
+        player.groundedState | player.landingState << 1 | player.dashingState << 2 | player.jumpingState << 3 
+            | player.canDash << 4 | player.queuedActionCount << 5 | (player.direction > 0) << 6,
+        heldKeys & (KEY_JUMP | KEY_DASH) // Held keys have to be released before they trigger again
+    };
+    uint64_t hash = 1469598103934665603ULL;
+    for (int64_t value : values) {
+        hash = (hash ^ (uint64_t) value) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Simulate one step from a state with new held keys
+ */
+void expand(Game& game, const Node& node, uint8_t heldKeys, int32_t parent, const vector<int>& distances, 
+        Vector2u levelSize, Vector2f goal, Node& child) {
+    game.restoreSnapshot(node.snapshot);
+
+    // Key presses and releases happen at the start of the step, then the keys stay held
+    Input input = Input();
+    for (int i = 0; i < 5; i++) {
+        if (node.heldKeys & (1 << i)) {
+            input.updateKeyPress(SOLVER_SCANCODES[i]);
+        }
+    }
+    input.clear();
+    for (int i = 0; i < 5; i++) {
+        if ((heldKeys & (1 << i)) && !(node.heldKeys & (1 << i))) {
+            input.updateKeyPress(SOLVER_SCANCODES[i]);
+        } else if (!(heldKeys & (1 << i)) && (node.heldKeys & (1 << i))) {
+            input.updateKeyRelease(SOLVER_SCANCODES[i]);
+        }
+    }
+
+    child.finishTick = 0;
+    for (int tick = 0; tick < STEP_TICKS; tick++) {
+        game.update(input);
+        input.clear();
+        if (game.isFinished()) {
+            child.finishTick = tick + 1;
+            break;
+        }
+    }
+
+    game.captureSnapshot(child.snapshot);
+    child.heldKeys = heldKeys;
+    child.parent = parent;
+    child.hash = hashState(child.snapshot, heldKeys);
+
+    Vector2f center = child.snapshot.player.hitboxPosition + HITBOX_SIZE / 2.0f;
+    int tileX = min(max((int) (center.x / TILE_SIZE.x), 0), (int) levelSize.x - 1);
+    int tileY = min(max((int) (center.y / TILE_SIZE.y), 0), (int) levelSize.y - 1);
+    child.tile = tileY * levelSize.x + tileX;
+    // Rising tiles left from the vertical speed, a grounded player has a whole jump
+    const PlayerSnapshot& player = child.snapshot.player;
+    int rise = player.groundedState ? JUMP_TILES 
+        : player.speed.y < 0 ? min(JUMP_TILES, (int) (player.speed.y * player.speed.y / (2 * 1000.0f) / TILE_SIZE.y)) : 0;
+    int distance = distances[getReachIndex({(int) child.tile, rise, player.canDash})];
+    // The straight distance in pixels only breaks ties between states on the same tile
+    child.score = (distance == INT32_MAX ? 1e6f : distance) + hypot(goal.x - center.x, goal.y - center.y) / 1e4f;
+}
+
+Route solve(Level& level, size_t threadCount, size_t beamWidth) {
+    Route route;
+    auto start = chrono::steady_clock::now();
+
+    // Spawned on their own to read the box of the fruit
+    EntityWorld world;
+    optional<FloatRect> fruit;
+    for (const EntitySpawn& spawn : level.entities) {
+        Entity entity = world.spawn(spawn);
+        if (world.has(entity, COMPONENT_COLLECTIBLE) && world.finishesLevel(entity)) {
+            fruit = world.getBounds(entity);
+        }
+    }
+    if (!fruit.has_value()) {
+        return route;
+    }
+    route.hasGoal = true;
+    FloatRect goal = *fruit;
+    vector<int> distances = buildDistanceField(level, goal);
+    vector<uint8_t> actions = getActions();
+
+    // One game per job, they all share the level
+    Camera camera = Camera(SCREEN_RESOLUTION);
+    Player player = Player(Vector2f(level.getSpawnPosition()));
+    Game prototype = Game(player, camera, level);
+    size_t jobCount = threadCount * JOBS_PER_THREAD;
+    vector<Game> games(jobCount, prototype);
+    WorkStealingPool pool(threadCount);
+
+    vector<Node> beam(1);
+    prototype.captureSnapshot(beam[0].snapshot);
+    unordered_set<uint64_t> visited = { hashState(beam[0].snapshot, 0) };
+    vector<vector<Step>> steps;
+    vector<vector<Node>> children(jobCount);
+    vector<uint8_t> statesInTile(level.getSize().x * level.getSize().y, 0);
+
+    for (size_t stepIndex = 0; stepIndex < MAX_STEPS && !beam.empty(); stepIndex++) {
+        size_t statesPerJob = (beam.size() + jobCount - 1) / jobCount;
+        for (size_t job = 0; job < jobCount; job++) {
+            pool.submit([&, job] {
+                size_t first = job * statesPerJob;
+                size_t last = min(beam.size(), first + statesPerJob);
+                children[job].resize(first < last ? (last - first) * actions.size() : 0);
+                for (size_t i = first; i < last; i++) {
+                    for (size_t a = 0; a < actions.size(); a++) {
+                        expand(games[job], beam[i], actions[a], i, distances, level.getSize(), goal.getCenter(), 
+                            children[job][(i - first) * actions.size() + a]);
+                    }
+                }
+            });
+        }
+        pool.wait();
+
+        // Merged in job order so the result does not depend on the number of threads
+        vector<const Node*> candidates;
+        const Node* finish = nullptr;
+        for (const vector<Node>& jobChildren : children) {
+            route.expandedStates += jobChildren.size();
+            for (const Node& child : jobChildren) {
+                if (child.finishTick != 0) {
+                    if (finish == nullptr || child.finishTick < finish->finishTick) {
+                        finish = &child;
+                    }
+                } else if (!child.snapshot.player.dyingState && visited.insert(child.hash).second) {
+                    candidates.push_back(&child);
+                }
+            }
+        }
+
+        if (finish != nullptr) {
+            route.found = true;
+            route.ticks = stepIndex * STEP_TICKS + finish->finishTick;
+            route.result = {finish->snapshot.player.hitboxPosition, finish->snapshot.clockTicks, true};
+            route.heldKeys.push_back(finish->heldKeys);
+            for (int32_t parent = finish->parent, s = stepIndex - 1; s >= 0; parent = steps[s][parent].parent, s--) {
+                route.heldKeys.push_back(steps[s][parent].heldKeys);
+            }
+            reverse(route.heldKeys.begin(), route.heldKeys.end());
+            break;
+        }
+
+        // Ties keep the merge order, stable_sort keeps the search deterministic
+        stable_sort(candidates.begin(), candidates.end(), [](const Node* a, const Node* b) { return a->score < b->score; });
+        vector<const Node*> selected;
+        for (const Node* candidate : candidates) {
+            if (selected.size() == beamWidth) {
+                break;
+            }
+            if (statesInTile[candidate->tile] < STATES_PER_TILE) {
+                statesInTile[candidate->tile]++;
+                selected.push_back(candidate);
+            }
+        }
+
+        vector<Node> nextBeam(selected.size());
+        steps.emplace_back(selected.size());
+        for (size_t i = 0; i < selected.size(); i++) {
+            nextBeam[i] = *selected[i];
+            steps.back()[i] = {selected[i]->parent, selected[i]->heldKeys};
+            statesInTile[selected[i]->tile] = 0;
+        }
+        beam = move(nextBeam);
+    }
+
+    route.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return route;
+}
+
+/**
+ * Save a route as an input recording, it can be watched with game --replay
+ */
+void recordRoute(const Route& route, string filename, string levelFilename) {
+    InputRecorder recorder = InputRecorder(filename, levelFilename, TICK_RATE);
+    uint8_t heldKeys = 0;
+    for (size_t step = 0; step < route.heldKeys.size(); step++) {
+        for (int i = 0; i < 5; i++) {
+            if ((route.heldKeys[step] & (1 << i)) && !(heldKeys & (1 << i))) {
+                recorder.recordKeyPress(step * STEP_TICKS, SOLVER_SCANCODES[i]);
+            } else if (!(route.heldKeys[step] & (1 << i)) && (heldKeys & (1 << i))) {
+                recorder.recordKeyRelease(step * STEP_TICKS, SOLVER_SCANCODES[i]);
+            }
+        }
+        heldKeys = route.heldKeys[step];
+    }
+    recorder.finish(route.ticks, route.result);
+}
+
+void printRoute(const Route& route) {
+    cout << "  route (held keys and ticks):";
+    for (size_t step = 0; step < route.heldKeys.size();) {
+        size_t end = step;
+        while (end < route.heldKeys.size() && route.heldKeys[end] == route.heldKeys[step]) {
+            end++;
+        }
+        cout << " " << describeKeys(route.heldKeys[step]) << " " << (end - step) * STEP_TICKS << (end < route.heldKeys.size() ? "," : "");
+        step = end;
+    }
+    cout << endl;
+}
+
+void bench(string levelFilename, size_t beamWidth) {
+    Level level = Level(levelFilename, LEVEL_TILESET);
+    level.loadAllChunks();
+
+    Route reference;
+    size_t maxThreads = max(1u, thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads = threads * 2 > maxThreads && threads < maxThreads ? maxThreads : threads * 2) {
+        Route route = solve(level, threads, beamWidth);
+        if (threads == 1) {
+            reference = route;
+        }
+        bool same = route.found == reference.found && route.ticks == reference.ticks && route.heldKeys == reference.heldKeys;
+        cout << setw(3) << threads << " threads: " << fixed << setprecision(2) << route.seconds << "s, " 
+            << (uint64_t) (route.expandedStates / route.seconds) << " states/s, speedup " << reference.seconds / route.seconds << "x"
+            << (same ? "" : ", DIFFERENT ROUTE") << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cout << "Usage: routeSolver [--threads <count>] [--beam <width>] [--record <file>] <level | directory>... | --bench <level> [width]" << endl;
+        return 1;
+    }
+
+    try {
+        if (strcmp(argv[1], "--bench") == 0 && argc > 2) {
+            bench(argv[2], argc > 3 ? stoi(argv[3]) : DEFAULT_BEAM_WIDTH);
+            return 0;
+        }
+
+        size_t threadCount = max(1u, thread::hardware_concurrency());
+        size_t beamWidth = DEFAULT_BEAM_WIDTH;
+        string recordingFilename;
+        vector<string> levelFilenames;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                threadCount = stoi(argv[++i]);
+            } else if (strcmp(argv[i], "--beam") == 0 && i + 1 < argc) {
+                beamWidth = stoi(argv[++i]);
+            } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                recordingFilename = argv[++i];
+            } else if (filesystem::is_directory(argv[i])) {
+                size_t first = levelFilenames.size();
+                for (const auto& entry : filesystem::directory_iterator(argv[i])) {
+                    if (entry.path().extension() == ".lvl" || entry.path().extension() == ".lvlb") {
+                        levelFilenames.push_back(entry.path().string());
+                    }
+                }
+                sort(levelFilenames.begin() + first, levelFilenames.end());
+            } else {
+                levelFilenames.push_back(argv[i]);
+            }
+        }
+
+        int unsolved = 0;
+        for (const string& levelFilename : levelFilenames) {
+            cout << levelFilename << ": " << flush;
+            Route route;
+            try {
+                Level level = Level(levelFilename, LEVEL_TILESET);
+                level.loadAllChunks();
+                route = solve(level, threadCount, beamWidth);
+            } catch (const exception& e) {
+                cout << e.what() << endl;
+                unsolved++;
+                continue;
+            }
+
+            cout << fixed;
+            if (route.found) {
+                cout << "completed in " << fixed << setprecision(3) << (double) route.result.levelTicks / TICK_RATE << "s";
+            } else if (!route.hasGoal) {
+                cout << "no sacred fruit to reach" << endl;
+                unsolved++;
+                continue;
+            } else {
+                cout << "no route found";
+                unsolved++;
+            }
+            cout << " (" << route.expandedStates << " states searched in " << setprecision(2) << route.seconds << "s)" << endl;
+
+            if (route.found) {
+                printRoute(route);
+                if (!recordingFilename.empty()) {
+                    // Several levels get one recording each, numbered after the first
+                    string filename = levelFilenames.size() == 1 ? recordingFilename 
+                        : recordingFilename + "." + to_string(&levelFilename - levelFilenames.data());
+                    recordRoute(route, filename, levelFilename);
+                }
+            }
+        }
+        return unsolved > 0 ? 1 : 0;
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}